@@ -1,12 +1,26 @@
 #ifndef ALGORITHM_HPP
 #define ALGORITHM_HPP
 
+#include "config.hpp"
+#include "iterator.hpp"
+
 namespace ft {
 
+/**
+ * @brief Exchanges a and b through a copy, or through moves when move
+ * support is enabled. The ft containers overload swap to exchange their
+ * contents in constant time instead.
+ */
 template <class T> void swap(T &a, T &b) {
+#if FT_HAS_MOVE
+  T c(std::move(a));
+  a = std::move(b);
+  b = std::move(c);
+#else
   T c(a);
   a = b;
   b = c;
+#endif
 }
 
 template <class InputIterator1, class InputIterator2>
@@ -61,6 +75,67 @@ bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
   return first2 != last2;
 }
 
+// Merges the sorted ranges [first1, last1) and [first2, last2) into out,
+// taking from the first range on ties
+template <class InputIterator1, class InputIterator2, class OutputIterator,
+          class Compare>
+OutputIterator _merge(InputIterator1 first1, InputIterator1 last1,
+                      InputIterator2 first2, InputIterator2 last2,
+                      OutputIterator out, Compare comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first2, *first1))
+      *out++ = *first2++;
+    else
+      *out++ = *first1++;
+  }
+  for (; first1 != last1; ++first1)
+    *out++ = *first1;
+  for (; first2 != last2; ++first2)
+    *out++ = *first2;
+  return out;
+}
+
+/**
+ * @brief Sorts [first, last) by comp, keeping equivalent elements in their
+ * original order, with [buffer, buffer + (last - first)) as scratch space.
+ *
+ * Runs of 16 elements are insertion sorted, then merged pairwise back and
+ * forth between the range and the buffer: O(n log n) comparisons and
+ * assignments, and no allocation.
+ */
+template <class RandomIterator, class Compare>
+void _merge_sort(RandomIterator first, RandomIterator last,
+                 RandomIterator buffer, Compare comp) {
+  typedef typename iterator_traits<RandomIterator>::difference_type
+      difference_type;
+  typedef typename iterator_traits<RandomIterator>::value_type value_type;
+  const difference_type run = 16;
+  const difference_type n = last - first;
+  for (difference_type lo = 0; lo < n; lo += run) {
+    RandomIterator end = first + (n - lo < run ? n : lo + run);
+    for (RandomIterator it = first + lo + 1; it < end; ++it) {
+      value_type value = *it;
+      RandomIterator hole = it;
+      for (; hole != first + lo && comp(value, *(hole - 1)); --hole)
+        *hole = *(hole - 1);
+      *hole = value;
+    }
+  }
+  RandomIterator from = first;
+  RandomIterator to = buffer;
+  for (difference_type width = run; width < n; width *= 2) {
+    for (difference_type lo = 0; lo < n; lo += 2 * width) {
+      difference_type mid = n - lo < width ? n : lo + width;
+      difference_type hi = n - lo < 2 * width ? n : lo + 2 * width;
+      _merge(from + lo, from + mid, from + mid, from + hi, to + lo, comp);
+    }
+    ft::swap(from, to);
+  }
+  if (from != first)
+    for (difference_type i = 0; i < n; i++)
+      first[i] = from[i];
+}
+
 } // namespace ft
 
 #endif
@@ -0,0 +1,33 @@
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+
+/*
+ * FT_HAS_MOVE enables the C++11 additions: move constructors and move
+ * assignment, rvalue overloads of the insertion functions, and relocation by
+ * move for elements whose move constructor cannot throw. It follows the
+ * language version unless it is defined beforehand, so that a C++11 build can
+ * still exercise the C++98 code paths with -DFT_HAS_MOVE=0.
+ */
+#ifndef FT_HAS_MOVE
+#if __cplusplus >= 201103L
+#define FT_HAS_MOVE 1
+#else
+#define FT_HAS_MOVE 0
+#endif
+#endif
+
+#if FT_HAS_MOVE
+#include <utility>
+#endif
+
+/*
+ * FT_PREFETCH(p) hints that the memory at p is about to be read, where the
+ * compiler offers a way to say so.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define FT_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define FT_PREFETCH(p) ((void)(p))
+#endif
+
+#endif
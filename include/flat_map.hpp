@@ -0,0 +1,672 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include "algorithm.hpp"
+#include "config.hpp"
+#include "functional.hpp"
+#include "iterator.hpp"
+#include "nullptr.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+#include <cstddef>
+#include <stdexcept>
+
+namespace ft {
+
+// The element references of a sequence container, const for a const one
+template <class Container> struct _flat_element {
+  typedef typename Container::reference reference;
+};
+
+template <class Container> struct _flat_element<const Container> {
+  typedef typename Container::const_reference reference;
+};
+
+/**
+ * @brief Iterator over a flat_map, walking its key and mapped value arrays
+ * in lockstep.
+ *
+ * Elements are not stored as pairs, so dereferencing yields a pair of
+ * references to the key and the mapped value, and operator-> a proxy
+ * holding one.
+ *
+ * @tparam KeyContainer The key container type.
+ * @tparam MappedContainer The mapped value container type, const for a
+ * const_iterator.
+ */
+template <class KeyContainer, class MappedContainer> class flat_map_iterator {
+public:
+  typedef typename KeyContainer::value_type key_type;
+  typedef typename MappedContainer::value_type mapped_type;
+  typedef ft::pair<key_type, mapped_type> value_type;
+  typedef ft::pair<const key_type &,
+                   typename _flat_element<MappedContainer>::reference>
+      reference;
+  typedef ft::ptrdiff_t difference_type;
+  typedef ft::random_access_iterator_tag iterator_category;
+
+  // Keeps the pair of references alive for operator->
+  class pointer {
+  public:
+    explicit pointer(const reference &ref) : _ref(ref) {}
+
+    const reference *operator->() const { return &_ref; }
+
+  private:
+    reference _ref;
+  };
+
+  typedef flat_map_iterator self;
+
+private:
+  const KeyContainer *_keys;
+  MappedContainer *_values;
+  difference_type _index;
+
+public:
+  flat_map_iterator() : _keys(_nullptr), _values(_nullptr), _index(0) {}
+
+  flat_map_iterator(const KeyContainer *keys, MappedContainer *values,
+                    difference_type index)
+      : _keys(keys), _values(values), _index(index) {}
+
+  // Converts an iterator to a const_iterator
+  template <class M>
+  flat_map_iterator(const flat_map_iterator<KeyContainer, M> &it)
+      : _keys(it.keys()), _values(it.values()), _index(it.index()) {}
+
+  reference operator*() const {
+    return reference((*_keys)[_index], (*_values)[_index]);
+  }
+
+  pointer operator->() const { return pointer(operator*()); }
+
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  self &operator++() {
+    ++_index;
+    return *this;
+  }
+
+  self operator++(int) {
+    self tmp(*this);
+    ++_index;
+    return tmp;
+  }
+
+  self &operator--() {
+    --_index;
+    return *this;
+  }
+
+  self operator--(int) {
+    self tmp(*this);
+    --_index;
+    return tmp;
+  }
+
+  self &operator+=(difference_type n) {
+    _index += n;
+    return *this;
+  }
+
+  self &operator-=(difference_type n) {
+    _index -= n;
+    return *this;
+  }
+
+  self operator+(difference_type n) const { return self(*this) += n; }
+
+  self operator-(difference_type n) const { return self(*this) -= n; }
+
+  // Accessors
+
+  const KeyContainer *keys() const { return _keys; }
+
+  MappedContainer *values() const { return _values; }
+
+  difference_type index() const { return _index; }
+};
+
+template <class K, class M1, class M2>
+bool operator==(const flat_map_iterator<K, M1> &lhs,
+                const flat_map_iterator<K, M2> &rhs) {
+  return lhs.index() == rhs.index();
+}
+
+template <class K, class M1, class M2>
+bool operator!=(const flat_map_iterator<K, M1> &lhs,
+                const flat_map_iterator<K, M2> &rhs) {
+  return lhs.index() != rhs.index();
+}
+
+template <class K, class M1, class M2>
+bool operator<(const flat_map_iterator<K, M1> &lhs,
+               const flat_map_iterator<K, M2> &rhs) {
+  return lhs.index() < rhs.index();
+}
+
+template <class K, class M1, class M2>
+bool operator>(const flat_map_iterator<K, M1> &lhs,
+               const flat_map_iterator<K, M2> &rhs) {
+  return rhs < lhs;
+}
+
+template <class K, class M1, class M2>
+bool operator<=(const flat_map_iterator<K, M1> &lhs,
+                const flat_map_iterator<K, M2> &rhs) {
+  return !(rhs < lhs);
+}
+
+template <class K, class M1, class M2>
+bool operator>=(const flat_map_iterator<K, M1> &lhs,
+                const flat_map_iterator<K, M2> &rhs) {
+  return !(lhs < rhs);
+}
+
+template <class K, class M1, class M2>
+typename flat_map_iterator<K, M1>::difference_type
+operator-(const flat_map_iterator<K, M1> &lhs,
+          const flat_map_iterator<K, M2> &rhs) {
+  return lhs.index() - rhs.index();
+}
+
+template <class K, class M>
+flat_map_iterator<K, M>
+operator+(typename flat_map_iterator<K, M>::difference_type n,
+          const flat_map_iterator<K, M> &it) {
+  return it + n;
+}
+
+/**
+ * @brief A flat map keeps its elements sorted by key in two parallel
+ * arrays, one of keys and one of mapped values, and finds them by binary
+ * search.
+ *
+ * Compared with the tree-based map, an element costs no node links and no
+ * allocation of its own, lookups touch a contiguous array of keys only, and
+ * iteration is a linear scan. Inserting or erasing a single element shifts
+ * the elements after it, in O(n); batches are sorted and merged in a
+ * single pass instead. Any insertion or erasure invalidates iterators.
+ *
+ * @tparam Key The type of the keys.
+ * @tparam T The type of the mapped values.
+ * @tparam Compare The comparison function object type.
+ * @tparam KeyContainer The random access sequence holding the keys.
+ * @tparam MappedContainer The random access sequence holding the values.
+ */
+template <class Key, class T, class Compare = ft::less<Key>,
+          class KeyContainer = ft::vector<Key>,
+          class MappedContainer = ft::vector<T>>
+class flat_map {
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef ft::pair<Key, T> value_type;
+  typedef Compare key_compare;
+  typedef KeyContainer key_container_type;
+  typedef MappedContainer mapped_container_type;
+  typedef flat_map_iterator<KeyContainer, MappedContainer> iterator;
+  typedef flat_map_iterator<KeyContainer, const MappedContainer>
+      const_iterator;
+  typedef ft::reverse_iterator<iterator> reverse_iterator;
+  typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef typename iterator::reference reference;
+  typedef typename const_iterator::reference const_reference;
+  typedef std::size_t size_type;
+  typedef ft::ptrdiff_t difference_type;
+
+  class value_compare : ft::binary_function<value_type, value_type, bool> {
+    friend class flat_map;
+
+  protected:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+
+  public:
+    typedef bool result_type;
+    typedef value_type first_argument_type;
+    typedef value_type second_argument_type;
+    bool operator()(const value_type &x, const value_type &y) const {
+      return comp(x.first, y.first);
+    }
+  };
+
+private:
+  key_container_type _keys;
+  mapped_container_type _values;
+  key_compare _comp;
+
+public:
+  // Constructors
+
+  /**
+   * @brief Constructs an empty flat map.
+   */
+  explicit flat_map(const key_compare &comp = key_compare())
+      : _comp(comp) {}
+
+  /**
+   * @brief Constructs a flat map with the elements in [first, last), sorted
+   * and merged as a single batch. Of equivalent keys, the first is kept.
+   */
+  template <class InputIterator>
+  flat_map(InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare())
+      : _comp(comp) {
+    insert(first, last);
+  }
+
+  /**
+   * @brief Constructs a flat map from a range sorted by comp and free of
+   * equivalent keys, as asserted by passing ft::sorted_unique, by appending
+   * each element without comparing any keys.
+   */
+  template <class InputIterator>
+  flat_map(ft::sorted_unique_t, InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare())
+      : _comp(comp) {
+    for (; first != last; ++first)
+      _push_back((*first).first, (*first).second);
+  }
+
+  /**
+   * @brief Constructs a flat map from parallel arrays of keys and values of
+   * the same length, which are sorted together. Of equivalent keys, the
+   * first is kept.
+   */
+  flat_map(const key_container_type &keys, const mapped_container_type &values,
+           const key_compare &comp = key_compare())
+      : _comp(comp) {
+    ft::vector<value_type> batch;
+    batch.reserve(keys.size());
+    for (size_type i = 0; i < keys.size(); i++)
+      batch.push_back(value_type(keys[i], values[i]));
+    _insert_batch(batch);
+  }
+
+  /**
+   * @brief Adopts parallel arrays of keys and values of the same length,
+   * already sorted by comp and free of equivalent keys, as asserted by
+   * passing ft::sorted_unique. Nothing is compared.
+   */
+  flat_map(ft::sorted_unique_t, const key_container_type &keys,
+           const mapped_container_type &values,
+           const key_compare &comp = key_compare())
+      : _keys(keys), _values(values), _comp(comp) {}
+
+  flat_map(const flat_map &x)
+      : _keys(x._keys), _values(x._values), _comp(x._comp) {}
+
+  flat_map &operator=(const flat_map &x) {
+    if (this != &x) {
+      flat_map tmp(x);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the arrays of x, leaving it empty.
+   */
+  flat_map(flat_map &&x) : _comp(x._comp) { swap(x); }
+
+  /**
+   * @brief Move assignment operator. Takes over the arrays of x, leaving it
+   * empty.
+   */
+  flat_map &operator=(flat_map &&x) {
+    clear();
+    swap(x);
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() { return iterator(&_keys, &_values, 0); }
+
+  const_iterator begin() const { return const_iterator(&_keys, &_values, 0); }
+
+  iterator end() { return iterator(&_keys, &_values, size()); }
+
+  const_iterator end() const {
+    return const_iterator(&_keys, &_values, size());
+  }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  const_reverse_iterator crbegin() const { return rbegin(); }
+
+  const_reverse_iterator crend() const { return rend(); }
+
+  // Capacity
+
+  bool empty() const { return _keys.empty(); }
+
+  size_type size() const { return _keys.size(); }
+
+  size_type max_size() const {
+    return _keys.max_size() < _values.max_size() ? _keys.max_size()
+                                                 : _values.max_size();
+  }
+
+  /**
+   * @brief Makes room for n elements, so that inserting up to n in all
+   * moves no element to new storage.
+   */
+  void reserve(size_type n) {
+    _keys.reserve(n);
+    _values.reserve(n);
+  }
+
+  // Element Access
+
+  /**
+   * @brief Returns a reference to the value mapped to k, inserting a
+   * default-constructed one if k is missing.
+   */
+  mapped_type &operator[](const key_type &k) {
+    size_type i = _lower_index(k);
+    if (i == size() || _comp(k, _keys[i]))
+      _insert_at(i, k, mapped_type());
+    return _values[i];
+  }
+
+  /**
+   * @brief Returns a reference to the value mapped to k.
+   *
+   * @throws std::out_of_range if k is missing.
+   */
+  mapped_type &at(const key_type &k) {
+    size_type i = _find_index(k);
+    if (i == size())
+      throw std::out_of_range("flat_map::at: key not found");
+    return _values[i];
+  }
+
+  const mapped_type &at(const key_type &k) const {
+    size_type i = _find_index(k);
+    if (i == size())
+      throw std::out_of_range("flat_map::at: key not found");
+    return _values[i];
+  }
+
+  // Modifiers
+
+  /**
+   * @brief Inserts val unless its key is present, shifting the elements
+   * after it.
+   *
+   * @return A pair of an iterator to the element with the key of val and
+   * whether the insertion took place.
+   */
+  ft::pair<iterator, bool> insert(const value_type &val) {
+    size_type i = _lower_index(val.first);
+    if (i != size() && !_comp(val.first, _keys[i]))
+      return ft::make_pair(_at(i), false);
+    _insert_at(i, val.first, val.second);
+    return ft::make_pair(_at(i), true);
+  }
+
+  /**
+   * @brief Inserts the elements of [first, last) as a batch.
+   *
+   * The batch is copied out and stably sorted, then merged with the
+   * elements in one pass, so inserting m elements into n takes
+   * O(m log m + n) rather than the O(m n) of one insertion at a time. Of
+   * equivalent keys, the ones already present win, then the first of the
+   * batch.
+   */
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    ft::vector<value_type> batch;
+    for (; first != last; ++first)
+      batch.push_back(value_type(*first));
+    _insert_batch(batch);
+  }
+
+  /**
+   * @brief Inserts a batch sorted by key_comp() and free of equivalent keys,
+   * as asserted by passing ft::sorted_unique, merging it with the elements
+   * in one pass, without sorting.
+   */
+  template <class InputIterator>
+  void insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+    _merge_sorted(first, last, size());
+  }
+
+  /**
+   * @brief Erases the element at pos, shifting the elements after it.
+   *
+   * @return An iterator to the element that followed the erased one.
+   */
+  iterator erase(const_iterator pos) {
+    _keys.erase(_keys.begin() + pos.index());
+    _values.erase(_values.begin() + pos.index());
+    return _at(pos.index());
+  }
+
+  size_type erase(const key_type &k) {
+    size_type i = _find_index(k);
+    if (i == size())
+      return 0;
+    erase(_at(i));
+    return 1;
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    _keys.erase(_keys.begin() + first.index(), _keys.begin() + last.index());
+    _values.erase(_values.begin() + first.index(),
+                  _values.begin() + last.index());
+    return _at(first.index());
+  }
+
+  void swap(flat_map &x) {
+    _keys.swap(x._keys);
+    _values.swap(x._values);
+    ft::swap(_comp, x._comp);
+  }
+
+  void clear() {
+    _keys.clear();
+    _values.clear();
+  }
+
+  // Observers
+
+  key_compare key_comp() const { return _comp; }
+
+  value_compare value_comp() const { return value_compare(_comp); }
+
+  /**
+   * @brief Returns the sorted array of keys, for scans that need no values.
+   */
+  const key_container_type &keys() const { return _keys; }
+
+  /**
+   * @brief Returns the array of values, in the order of their keys.
+   */
+  const mapped_container_type &values() const { return _values; }
+
+  // Operations
+
+  iterator find(const key_type &k) { return _at(_find_index(k)); }
+
+  const_iterator find(const key_type &k) const { return _at(_find_index(k)); }
+
+  size_type count(const key_type &k) const {
+    return _find_index(k) == size() ? 0 : 1;
+  }
+
+  iterator lower_bound(const key_type &k) { return _at(_lower_index(k)); }
+
+  const_iterator lower_bound(const key_type &k) const {
+    return _at(_lower_index(k));
+  }
+
+  iterator upper_bound(const key_type &k) { return _at(_upper_index(k)); }
+
+  const_iterator upper_bound(const key_type &k) const {
+    return _at(_upper_index(k));
+  }
+
+  ft::pair<iterator, iterator> equal_range(const key_type &k) {
+    return ft::make_pair(lower_bound(k), upper_bound(k));
+  }
+
+  ft::pair<const_iterator, const_iterator>
+  equal_range(const key_type &k) const {
+    return ft::make_pair(lower_bound(k), upper_bound(k));
+  }
+
+private:
+  // Orders elements of the batches by key
+  struct _batch_compare {
+    key_compare comp;
+
+    _batch_compare(const key_compare &c) : comp(c) {}
+
+    bool operator()(const value_type &a, const value_type &b) const {
+      return comp(a.first, b.first);
+    }
+  };
+
+  iterator _at(size_type i) { return iterator(&_keys, &_values, i); }
+
+  const_iterator _at(size_type i) const {
+    return const_iterator(&_keys, &_values, i);
+  }
+
+  /* @brief Returns the index of the first key not less than k, by binary
+   * search over the key array alone.
+   */
+  size_type _lower_index(const key_type &k) const {
+    size_type first = 0;
+    size_type n = size();
+    while (n > 0) {
+      size_type half = n / 2;
+      if (_comp(_keys[first + half], k)) {
+        first += half + 1;
+        n -= half + 1;
+      } else {
+        n = half;
+      }
+    }
+    return first;
+  }
+
+  // Returns the index past the key equivalent to k, keys being unique
+  size_type _upper_index(const key_type &k) const {
+    size_type i = _lower_index(k);
+    return i == size() || _comp(k, _keys[i]) ? i : i + 1;
+  }
+
+  // Returns the index of the key equivalent to k, or size() if there is none
+  size_type _find_index(const key_type &k) const {
+    size_type i = _lower_index(k);
+    if (i != size() && _comp(k, _keys[i]))
+      return size();
+    return i;
+  }
+
+  // Inserts at index i in both arrays, or in neither
+  void _insert_at(size_type i, const key_type &k, const mapped_type &v) {
+    _keys.insert(_keys.begin() + i, k);
+    try {
+      _values.insert(_values.begin() + i, v);
+    } catch (...) {
+      _keys.erase(_keys.begin() + i);
+      throw;
+    }
+  }
+
+  void _push_back(const key_type &k, const mapped_type &v) {
+    _keys.push_back(k);
+    try {
+      _values.push_back(v);
+    } catch (...) {
+      _keys.pop_back();
+      throw;
+    }
+  }
+
+  void _insert_batch(ft::vector<value_type> &batch) {
+    ft::vector<value_type> buffer(batch);
+    ft::_merge_sort(batch.begin(), batch.end(), buffer.begin(),
+                    _batch_compare(_comp));
+    _merge_sorted(batch.begin(), batch.end(), size() + batch.size());
+  }
+
+  /* @brief Merges a sorted batch into the elements in one pass, skipping
+   * the keys already present and the repeats within the batch.
+   *
+   * A batch that goes entirely after the last key is appended in place.
+   * Otherwise the merge is written to new arrays of capacity hint, which
+   * replace the current ones only once complete.
+   */
+  template <class InputIterator>
+  void _merge_sorted(InputIterator first, InputIterator last, size_type hint) {
+    if (first == last)
+      return;
+    if (empty() || _comp(_keys.back(), (*first).first)) {
+      for (; first != last; ++first)
+        if (empty() || _comp(_keys.back(), (*first).first))
+          _push_back((*first).first, (*first).second);
+      return;
+    }
+    flat_map merged(_comp);
+    merged.reserve(hint);
+    size_type i = 0;
+    for (; first != last; ++first) {
+      const key_type &k = (*first).first;
+      for (; i < size() && _comp(_keys[i], k); i++)
+        merged._push_back(_keys[i], _values[i]);
+      if (i < size() && !_comp(k, _keys[i]))
+        continue;
+      if (!merged.empty() && !_comp(merged._keys.back(), k))
+        continue;
+      merged._push_back(k, (*first).second);
+    }
+    for (; i < size(); i++)
+      merged._push_back(_keys[i], _values[i]);
+    swap(merged);
+  }
+};
+
+template <class Key, class T, class Compare, class KC, class MC>
+bool operator==(const flat_map<Key, T, Compare, KC, MC> &lhs,
+                const flat_map<Key, T, Compare, KC, MC> &rhs) {
+  return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+}
+
+template <class Key, class T, class Compare, class KC, class MC>
+bool operator!=(const flat_map<Key, T, Compare, KC, MC> &lhs,
+                const flat_map<Key, T, Compare, KC, MC> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class KC, class MC>
+void swap(flat_map<Key, T, Compare, KC, MC> &lhs,
+          flat_map<Key, T, Compare, KC, MC> &rhs) {
+  lhs.swap(rhs);
+}
+
+} // namespace ft
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef FLAT_SET_HPP
+#define FLAT_SET_HPP
+
+#include "algorithm.hpp"
+#include "config.hpp"
+#include "functional.hpp"
+#include "iterator.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+#include <cstddef>
+
+namespace ft {
+
+/**
+ * @brief A flat set keeps its elements sorted in an array, and finds them by
+ * binary search.
+ *
+ * It is the set counterpart of flat_map: lookups and iteration are scans of
+ * contiguous memory, single insertions and erasures shift the elements
+ * after them, and batches are sorted and merged in a single pass. Any
+ * insertion or erasure invalidates iterators. Elements are read-only
+ * through iterators, as in ft::set.
+ *
+ * @tparam Key The type of the elements.
+ * @tparam Compare The comparison function object type.
+ * @tparam KeyContainer The random access sequence holding the elements.
+ */
+template <class Key, class Compare = ft::less<Key>,
+          class KeyContainer = ft::vector<Key>>
+class flat_set {
+public:
+  typedef Key value_type;
+  typedef Key key_type;
+  typedef Compare key_compare;
+  typedef Compare value_compare;
+  typedef KeyContainer container_type;
+  typedef typename KeyContainer::const_reference reference;
+  typedef typename KeyContainer::const_reference const_reference;
+  typedef typename KeyContainer::const_iterator iterator;
+  typedef typename KeyContainer::const_iterator const_iterator;
+  typedef ft::reverse_iterator<iterator> reverse_iterator;
+  typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef std::size_t size_type;
+  typedef typename iterator_traits<iterator>::difference_type difference_type;
+
+private:
+  container_type _keys;
+  key_compare _comp;
+
+public:
+  // Constructors
+
+  /**
+   * @brief Constructs an empty flat set.
+   */
+  explicit flat_set(const key_compare &comp = key_compare()) : _comp(comp) {}
+
+  /**
+   * @brief Constructs a flat set with the elements in [first, last), sorted
+   * and merged as a single batch. Of equivalent elements, the first is kept.
+   */
+  template <class InputIterator>
+  flat_set(InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare())
+      : _comp(comp) {
+    insert(first, last);
+  }
+
+  /**
+   * @brief Constructs a flat set from a range sorted by comp and free of
+   * equivalent elements, as asserted by passing ft::sorted_unique, by
+   * appending each element without comparing any.
+   */
+  template <class InputIterator>
+  flat_set(ft::sorted_unique_t, InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare())
+      : _comp(comp) {
+    for (; first != last; ++first)
+      _keys.push_back(*first);
+  }
+
+  /**
+   * @brief Constructs a flat set from an array of elements, which is sorted.
+   * Of equivalent elements, the first is kept.
+   */
+  explicit flat_set(const container_type &keys,
+                    const key_compare &comp = key_compare())
+      : _comp(comp) {
+    container_type batch(keys);
+    _insert_batch(batch);
+  }
+
+  /**
+   * @brief Adopts an array of elements already sorted by comp and free of
+   * equivalent elements, as asserted by passing ft::sorted_unique. Nothing
+   * is compared.
+   */
+  flat_set(ft::sorted_unique_t, const container_type &keys,
+           const key_compare &comp = key_compare())
+      : _keys(keys), _comp(comp) {}
+
+  flat_set(const flat_set &x) : _keys(x._keys), _comp(x._comp) {}
+
+  flat_set &operator=(const flat_set &x) {
+    if (this != &x) {
+      flat_set tmp(x);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the array of x, leaving it empty.
+   */
+  flat_set(flat_set &&x) : _comp(x._comp) { swap(x); }
+
+  /**
+   * @brief Move assignment operator. Takes over the array of x, leaving it
+   * empty.
+   */
+  flat_set &operator=(flat_set &&x) {
+    clear();
+    swap(x);
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() const { return _keys.begin(); }
+
+  iterator end() const { return _keys.end(); }
+
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+  // Capacity
+
+  bool empty() const { return _keys.empty(); }
+
+  size_type size() const { return _keys.size(); }
+
+  size_type max_size() const { return _keys.max_size(); }
+
+  /**
+   * @brief Makes room for n elements, so that inserting up to n in all
+   * moves no element to new storage.
+   */
+  void reserve(size_type n) { _keys.reserve(n); }
+
+  // Modifiers
+
+  /**
+   * @brief Inserts val unless an equivalent element is present, shifting the
+   * elements after it.
+   *
+   * @return A pair of an iterator to the element equivalent to val and
+   * whether the insertion took place.
+   */
+  ft::pair<iterator, bool> insert(const value_type &val) {
+    size_type i = _lower_index(val);
+    if (i != size() && !_comp(val, _keys[i]))
+      return ft::make_pair(_at(i), false);
+    _keys.insert(_keys.begin() + i, val);
+    return ft::make_pair(_at(i), true);
+  }
+
+  /**
+   * @brief Inserts the elements of [first, last) as a batch.
+   *
+   * The batch is copied out and stably sorted, then merged with the
+   * elements in one pass, in O(m log m + n) for m elements into n. Of
+   * equivalent elements, the ones already present win, then the first of
+   * the batch.
+   */
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    container_type batch;
+    for (; first != last; ++first)
+      batch.push_back(*first);
+    _insert_batch(batch);
+  }
+
+  /**
+   * @brief Inserts a batch sorted by key_comp() and free of equivalent
+   * elements, as asserted by passing ft::sorted_unique, merging it with the
+   * elements in one pass, without sorting.
+   */
+  template <class InputIterator>
+  void insert(ft::sorted_unique_t, InputIterator first, InputIterator last) {
+    _merge_sorted(first, last, size());
+  }
+
+  /**
+   * @brief Erases the element at pos, shifting the elements after it.
+   *
+   * @return An iterator to the element that followed the erased one.
+   */
+  iterator erase(const_iterator pos) {
+    size_type i = pos - begin();
+    _keys.erase(_keys.begin() + i);
+    return _at(i);
+  }
+
+  size_type erase(const key_type &k) {
+    size_type i = _find_index(k);
+    if (i == size())
+      return 0;
+    _keys.erase(_keys.begin() + i);
+    return 1;
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    size_type i = first - begin();
+    _keys.erase(_keys.begin() + i, _keys.begin() + (last - begin()));
+    return _at(i);
+  }
+
+  void swap(flat_set &x) {
+    _keys.swap(x._keys);
+    ft::swap(_comp, x._comp);
+  }
+
+  void clear() { _keys.clear(); }
+
+  // Observers
+
+  key_compare key_comp() const { return _comp; }
+
+  value_compare value_comp() const { return _comp; }
+
+  /**
+   * @brief Returns the sorted array of elements.
+   */
+  const container_type &keys() const { return _keys; }
+
+  // Operations
+
+  iterator find(const key_type &k) const { return _at(_find_index(k)); }
+
+  size_type count(const key_type &k) const {
+    return _find_index(k) == size() ? 0 : 1;
+  }
+
+  iterator lower_bound(const key_type &k) const {
+    return _at(_lower_index(k));
+  }
+
+  iterator upper_bound(const key_type &k) const {
+    size_type i = _lower_index(k);
+    return _at(i == size() || _comp(k, _keys[i]) ? i : i + 1);
+  }
+
+  ft::pair<iterator, iterator> equal_range(const key_type &k) const {
+    return ft::make_pair(lower_bound(k), upper_bound(k));
+  }
+
+private:
+  iterator _at(size_type i) const { return _keys.begin() + i; }
+
+  // Returns the index of the first element not less than k
+  size_type _lower_index(const key_type &k) const {
+    size_type first = 0;
+    size_type n = size();
+    while (n > 0) {
+      size_type half = n / 2;
+      if (_comp(_keys[first + half], k)) {
+        first += half + 1;
+        n -= half + 1;
+      } else {
+        n = half;
+      }
+    }
+    return first;
+  }
+
+  // Returns the index of the element equivalent to k, or size() if none is
+  size_type _find_index(const key_type &k) const {
+    size_type i = _lower_index(k);
+    if (i != size() && _comp(k, _keys[i]))
+      return size();
+    return i;
+  }
+
+  void _insert_batch(container_type &batch) {
+    container_type buffer(batch);
+    ft::_merge_sort(batch.begin(), batch.end(), buffer.begin(), _comp);
+    _merge_sorted(batch.begin(), batch.end(), size() + batch.size());
+  }
+
+  /* @brief Merges a sorted batch into the elements in one pass, skipping
+   * the elements already present and the repeats within the batch.
+   *
+   * A batch that goes entirely after the last element is appended in place.
+   * Otherwise the merge is written to a new array of capacity hint, which
+   * replaces the current one only once complete.
+   */
+  template <class InputIterator>
+  void _merge_sorted(InputIterator first, InputIterator last, size_type hint) {
+    if (first == last)
+      return;
+    if (empty() || _comp(_keys.back(), *first)) {
+      for (; first != last; ++first)
+        if (empty() || _comp(_keys.back(), *first))
+          _keys.push_back(*first);
+      return;
+    }
+    container_type merged;
+    merged.reserve(hint);
+    size_type i = 0;
+    for (; first != last; ++first) {
+      const key_type &k = *first;
+      for (; i < size() && _comp(_keys[i], k); i++)
+        merged.push_back(_keys[i]);
+      if (i < size() && !_comp(k, _keys[i]))
+        continue;
+      if (!merged.empty() && !_comp(merged.back(), k))
+        continue;
+      merged.push_back(k);
+    }
+    for (; i < size(); i++)
+      merged.push_back(_keys[i]);
+    _keys.swap(merged);
+  }
+};
+
+template <class Key, class Compare, class KeyContainer>
+bool operator==(const flat_set<Key, Compare, KeyContainer> &lhs,
+                const flat_set<Key, Compare, KeyContainer> &rhs) {
+  return lhs.keys() == rhs.keys();
+}
+
+template <class Key, class Compare, class KeyContainer>
+bool operator!=(const flat_set<Key, Compare, KeyContainer> &lhs,
+                const flat_set<Key, Compare, KeyContainer> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class KeyContainer>
+void swap(flat_set<Key, Compare, KeyContainer> &lhs,
+          flat_set<Key, Compare, KeyContainer> &rhs) {
+  lhs.swap(rhs);
+}
+
+} // namespace ft
+
+#endif
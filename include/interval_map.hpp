@@ -0,0 +1,383 @@
+#ifndef INTERVAL_MAP_HPP
+#define INTERVAL_MAP_HPP
+
+#include "algorithm.hpp"
+#include "config.hpp"
+#include "functional.hpp"
+#include "iterator.hpp"
+#include "tree.hpp"
+#include "utility.hpp"
+#include <cstddef>
+#include <memory>
+
+namespace ft {
+
+// Orders intervals by start, then by end
+template <class Key, class Compare>
+struct _interval_compare
+    : binary_function<ft::pair<Key, Key>, ft::pair<Key, Key>, bool> {
+  Compare comp;
+
+  _interval_compare(const Compare &c = Compare()) : comp(c) {}
+
+  bool operator()(const ft::pair<Key, Key> &a,
+                  const ft::pair<Key, Key> &b) const {
+    if (comp(a.first, b.first))
+      return true;
+    if (comp(b.first, a.first))
+      return false;
+    return comp(a.second, b.second);
+  }
+};
+
+// The greatest interval end in a subtree; empty for no intervals
+template <class Key> struct _interval_end {
+  Key end;
+  bool empty;
+};
+
+/**
+ * @brief The monoid behind the max-endpoint augmentation of interval_map,
+ * taking the latest end of the intervals in a subtree.
+ *
+ * Compare is default-constructed to compare ends, as the tree updates
+ * summaries without an instance of the monoid; interval_map accepts
+ * stateless comparators only, for which every instance is the same.
+ */
+template <class Key, class Compare> struct _interval_end_monoid {
+  typedef _interval_end<Key> result_type;
+
+  result_type identity() const {
+    result_type none;
+    none.end = Key();
+    none.empty = true;
+    return none;
+  }
+
+  template <class Value> result_type lift(const Value &value) const {
+    result_type end;
+    end.end = value.first.second;
+    end.empty = false;
+    return end;
+  }
+
+  result_type combine(const result_type &a, const result_type &b) const {
+    if (a.empty)
+      return b;
+    if (b.empty || !Compare()(a.end, b.end))
+      return a;
+    return b;
+  }
+};
+
+/**
+ * @brief An interval map stores values keyed by half-open intervals
+ * [start, end), and finds the intervals that overlap a range or contain a
+ * point.
+ *
+ * The elements live in a RedBlackTree ordered by start, then end, whose
+ * nodes also keep the latest end in their subtree. Queries use it to skip
+ * every subtree whose intervals all end too early, so that reporting k
+ * intervals visits O(log n + k) nodes in typical workloads, and no more than
+ * O(k log n). Intervals are unique keys: inserting an interval that is
+ * already present does nothing, as in ft::map. The end of each interval is
+ * expected not to precede its start.
+ *
+ * @tparam Key The type of the interval endpoints. It must be trivially
+ * copyable, as the latest ends are kept in raw node storage.
+ * @tparam T The type of the mapped values.
+ * @tparam Compare The comparison function object type for endpoints. It
+ * must be an empty class, as the latest ends are kept with a
+ * default-constructed Compare; function pointers and comparators with
+ * state are rejected at compile time.
+ * @tparam Alloc The allocator type.
+ */
+template <class Key, class T, class Compare = ft::less<Key>,
+          class Alloc = std::allocator<
+              ft::pair<const ft::pair<Key, Key>, T>>>
+class interval_map {
+public:
+  typedef Key endpoint_type;
+  typedef ft::pair<Key, Key> key_type;
+  typedef T mapped_type;
+  typedef ft::pair<const key_type, T> value_type;
+  typedef Compare endpoint_compare;
+  typedef _interval_compare<Key, Compare> key_compare;
+  typedef Alloc allocator_type;
+
+private:
+  typedef RedBlackTree<
+      key_type, T, _Select1st<value_type>, key_compare, Alloc,
+      rb_aggregate_policy<_interval_end_monoid<Key, Compare>>>
+      _tree_type;
+  typedef typename _tree_type::node_ptr _node_ptr;
+
+  typedef char _check_stateless_compare[ft::is_empty<Compare>::value ? 1 : -1];
+
+public:
+  typedef typename allocator_type::reference reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::pointer pointer;
+  typedef typename allocator_type::const_pointer const_pointer;
+  typedef typename _tree_type::iterator iterator;
+  typedef typename _tree_type::const_iterator const_iterator;
+  typedef typename _tree_type::reverse_iterator reverse_iterator;
+  typedef typename _tree_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _tree_type::size_type size_type;
+  typedef typename iterator_traits<iterator>::difference_type difference_type;
+
+private:
+  _tree_type _tree;
+
+public:
+  // Constructors
+
+  explicit interval_map(const endpoint_compare &comp = endpoint_compare(),
+                        const allocator_type &alloc = allocator_type())
+      : _tree(key_compare(comp), alloc) {}
+
+  /**
+   * @brief Constructs an interval map with the elements in [first, last).
+   */
+  template <class InputIterator>
+  interval_map(InputIterator first, InputIterator last,
+               const endpoint_compare &comp = endpoint_compare(),
+               const allocator_type &alloc = allocator_type())
+      : _tree(key_compare(comp), alloc) {
+    _tree.insert_unique(first, last);
+  }
+
+  /**
+   * @brief Constructs an interval map in linear time from a range sorted by
+   * key_comp() and free of equal intervals, as asserted by passing
+   * ft::sorted_unique.
+   */
+  template <class ForwardIterator>
+  interval_map(ft::sorted_unique_t tag, ForwardIterator first,
+               ForwardIterator last,
+               const endpoint_compare &comp = endpoint_compare(),
+               const allocator_type &alloc = allocator_type())
+      : _tree(key_compare(comp), alloc) {
+    _tree.insert_unique(tag, first, last);
+  }
+
+  interval_map(const interval_map &x) : _tree(x._tree) {}
+
+  interval_map &operator=(const interval_map &x) {
+    _tree = x._tree;
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the nodes of x, leaving it empty.
+   */
+  interval_map(interval_map &&x) noexcept : _tree(std::move(x._tree)) {}
+
+  /**
+   * @brief Move assignment operator. Takes over the nodes of x, leaving it
+   * empty.
+   */
+  interval_map &operator=(interval_map &&x) {
+    _tree = std::move(x._tree);
+    return *this;
+  }
+#endif
+
+  // Iterators, in order of start, then end
+
+  iterator begin() { return _tree.begin(); }
+
+  const_iterator begin() const { return _tree.begin(); }
+
+  iterator end() { return _tree.end(); }
+
+  const_iterator end() const { return _tree.end(); }
+
+  reverse_iterator rbegin() { return _tree.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _tree.rbegin(); }
+
+  reverse_iterator rend() { return _tree.rend(); }
+
+  const_reverse_iterator rend() const { return _tree.rend(); }
+
+  // Capacity
+
+  bool empty() const { return _tree.empty(); }
+
+  size_type size() const { return _tree.size(); }
+
+  size_type max_size() const { return _tree.max_size(); }
+
+  // Modifiers
+
+  /**
+   * @brief Inserts val, unless its interval is already present.
+   *
+   * @return A pair of an iterator to the element with the interval of val
+   * and whether the insertion took place.
+   */
+  ft::pair<iterator, bool> insert(const value_type &val) {
+    return _tree.insert_unique(val);
+  }
+
+  /**
+   * @brief Inserts the value v for the interval [start, end).
+   */
+  ft::pair<iterator, bool> insert(const Key &start, const Key &end,
+                                  const mapped_type &v) {
+    return _tree.insert_unique(value_type(key_type(start, end), v));
+  }
+
+  /**
+   * @brief Inserts the elements of [first, last) as a batch, skipping the
+   * intervals already present.
+   */
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    _tree.insert_unique(first, last);
+  }
+
+  /**
+   * @brief Inserts a batch sorted by key_comp() and free of equal intervals,
+   * as asserted by passing ft::sorted_unique. An empty interval map is built
+   * in linear time, latest ends included.
+   */
+  template <class ForwardIterator>
+  void insert(ft::sorted_unique_t tag, ForwardIterator first,
+              ForwardIterator last) {
+    _tree.insert_unique(tag, first, last);
+  }
+
+  void erase(iterator pos) { _tree.erase(pos); }
+
+  size_type erase(const key_type &interval) { return _tree.erase(interval); }
+
+  void erase(iterator first, iterator last) { _tree.erase(first, last); }
+
+  void swap(interval_map &x) { _tree.swap(x._tree); }
+
+  void clear() { _tree.clear(); }
+
+  // Lookup
+
+  iterator find(const key_type &interval) { return _tree.find(interval); }
+
+  const_iterator find(const key_type &interval) const {
+    return _tree.find(interval);
+  }
+
+  size_type count(const key_type &interval) const {
+    return _tree.count(interval);
+  }
+
+  /**
+   * @brief Writes an iterator to each element whose interval overlaps
+   * [lo, hi), in key order.
+   *
+   * @param lo The start of the range.
+   * @param hi The end of the range, which is excluded.
+   * @param out An output iterator accepting iterator values.
+   * @return out, past the last iterator written.
+   */
+  template <class OutputIterator>
+  OutputIterator overlapping(const Key &lo, const Key &hi,
+                             OutputIterator out) {
+    return _overlapping<iterator>(lo, hi, false, out);
+  }
+
+  template <class OutputIterator>
+  OutputIterator overlapping(const Key &lo, const Key &hi,
+                             OutputIterator out) const {
+    return _overlapping<const_iterator>(lo, hi, false, out);
+  }
+
+  /**
+   * @brief Writes an iterator to each element whose interval contains
+   * point, in key order.
+   *
+   * @return out, past the last iterator written.
+   */
+  template <class OutputIterator>
+  OutputIterator stabbing(const Key &point, OutputIterator out) {
+    return _overlapping<iterator>(point, point, true, out);
+  }
+
+  template <class OutputIterator>
+  OutputIterator stabbing(const Key &point, OutputIterator out) const {
+    return _overlapping<const_iterator>(point, point, true, out);
+  }
+
+  // Observers
+
+  key_compare key_comp() const { return _tree.key_comp(); }
+
+  endpoint_compare endpoint_comp() const { return _tree.key_comp().comp; }
+
+  allocator_type get_allocator() const { return _tree.get_allocator(); }
+
+private:
+  /* @brief Reports the intervals that end after lo and start before hi, or
+   * at hi too if closed, walking each subtree in order.
+   *
+   * A subtree is skipped whole when its latest end is not after lo, and the
+   * walk stops at the first start past hi, as every later start is too.
+   * Only left subtrees are entered recursively, so the depth stays within
+   * the height of the tree.
+   */
+  template <class It, class OutputIterator>
+  OutputIterator _overlapping(const Key &lo, const Key &hi, bool closed,
+                              OutputIterator out) const {
+    Compare comp = endpoint_comp();
+    _node_ptr nil = _tree.get_nil();
+    bool done = false;
+    return _visit<It>(_tree.get_root(), nil, comp, lo, hi, closed, done, out);
+  }
+
+  template <class It, class OutputIterator>
+  static OutputIterator _visit(_node_ptr x, _node_ptr nil,
+                               const Compare &comp, const Key &lo,
+                               const Key &hi, bool closed, bool &done,
+                               OutputIterator out) {
+    while (x != nil && !done) {
+      if (!comp(lo, x->summary.end))
+        break;
+      out = _visit<It>(x->left, nil, comp, lo, hi, closed, done, out);
+      if (done)
+        break;
+      const key_type &interval = x->data.first;
+      if (closed ? comp(hi, interval.first) : !comp(interval.first, hi)) {
+        done = true;
+        break;
+      }
+      if (comp(lo, interval.second))
+        *out++ = It(x, nil);
+      x = x->right;
+    }
+    return out;
+  }
+};
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const interval_map<Key, T, Compare, Alloc> &lhs,
+                const interval_map<Key, T, Compare, Alloc> &rhs) {
+  return lhs.size() == rhs.size() &&
+         ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const interval_map<Key, T, Compare, Alloc> &lhs,
+                const interval_map<Key, T, Compare, Alloc> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+void swap(interval_map<Key, T, Compare, Alloc> &lhs,
+          interval_map<Key, T, Compare, Alloc> &rhs) {
+  lhs.swap(rhs);
+}
+
+} // namespace ft
+
+#endif
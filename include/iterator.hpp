@@ -117,12 +117,23 @@ public:
     return tmp;
   }
 
-  pointer operator->() const { return &(operator*()); }
+  // Asks the underlying iterator, whose pointer may be a proxy rather than
+  // the address of its reference
+  pointer operator->() const {
+    iterator_type tmp = _it;
+    return _arrow(--tmp);
+  }
 
   reference operator[](difference_type n) const { return base()[-n - 1]; }
 
 private:
   iterator_type _it;
+
+  template <class T> static T *_arrow(T *it) { return it; }
+
+  template <class It> static pointer _arrow(const It &it) {
+    return it.operator->();
+  }
 };
 
 template <class Iterator>
@@ -2,6 +2,7 @@
 #define MAP_HPP
 
 #include "algorithm.hpp"
+#include "config.hpp"
 #include "functional.hpp"
 #include "iterator.hpp"
 #include "tree.hpp"
@@ -17,13 +18,20 @@ namespace ft {
  * and non-unique keys. The map is also called associative array or
  * dictionary.
  *
+ * Under a policy that keeps a summary of the mapped values, such as
+ * ft::rb_aggregate_policy, the elements are read-only through iterators and
+ * operator[] does not compile, so that every write goes through
+ * insert_or_assign() and the summaries stay current.
+ *
  * @tparam Key The type of the keys.
  * @tparam T The type of the mapped values.
  * @tparam Compare The comparison function object type.
  * @tparam Allocator The allocator type.
+ * @tparam Policy The tree policy, selecting the node layout.
  */
 template <class Key, class T, class Compare = ft::less<Key>,
-          class Alloc = std::allocator<ft::pair<const Key, T>>>
+          class Alloc = std::allocator<ft::pair<const Key, T>>,
+          class Policy = ft::rb_default_policy>
 class map {
 
 public:
@@ -50,7 +58,12 @@ public:
   };
 
 private:
-  typedef RedBlackTree<Key, T, _Select1st<value_type>, Compare, Alloc>
+  static const bool _summarized_values = !ft::is_void<
+      typename Policy::template rebind<value_type>::other::augment_type::
+          summary_type>::value;
+
+  typedef RedBlackTree<Key, T, _Select1st<value_type>, Compare, Alloc, Policy,
+                       _summarized_values>
       _tree_type;
 
 public:
@@ -64,6 +77,7 @@ public:
   typedef typename _tree_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _tree_type::size_type size_type;
   typedef typename iterator_traits<iterator>::difference_type difference_type;
+  typedef typename _tree_type::summary_type summary_type;
 
 private:
   _tree_type _tree;
@@ -102,6 +116,26 @@ public:
     _tree.insert_unique(first, last);
   };
 
+  /**
+   * @brief Sorted Range Constructor
+   *
+   * @param tag ft::sorted_unique, asserting the range is sorted by comp and
+   * has no equivalent keys.
+   * @param first The iterator to the first element in the range.
+   * @param last The iterator to the last element in the range.
+   * @param comp The comparison function object.
+   * @param alloc The allocator object.
+   *
+   * Builds the container in linear time, without comparing any keys.
+   */
+  template <class ForwardIterator>
+  map(ft::sorted_unique_t tag, ForwardIterator first, ForwardIterator last,
+      const key_compare &comp = key_compare(),
+      const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {
+    _tree.insert_unique(tag, first, last);
+  }
+
   /**
    * @brief Copy Constructor
    *
@@ -137,6 +171,30 @@ public:
     return *this;
   }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Move Constructor
+   *
+   * @param x The other map, left empty.
+   *
+   * Takes over the nodes of x without copying any element. Iterators to
+   * elements of x now refer to elements of this map.
+   */
+  map(map &&x) noexcept : _tree(std::move(x._tree)) {}
+
+  /**
+   * @brief Move Assignment Operator
+   *
+   * @param x The other map, left empty.
+   *
+   * Destroys the current elements and takes over the nodes of x.
+   */
+  map &operator=(map &&x) {
+    _tree = std::move(x._tree);
+    return *this;
+  }
+#endif
+
   // Iterators
 
   iterator begin() { return _tree.begin(); }
@@ -186,9 +244,16 @@ public:
    * @param key The key of the element to return.
    *
    * @return A reference to the element with the specified key.
+   *
+   * Nothing is constructed unless the key is missing, in which case the
+   * mapped value is default-constructed in place, as by try_emplace(k).
+   * Does not compile under a policy that summarizes the mapped values, as
+   * the summaries would miss writes through the reference.
    */
   mapped_type &operator[](const key_type &k) {
-    return (*((insert(make_pair(k, mapped_type()))).first)).second;
+    typedef char _check_unsummarized[_summarized_values ? -1 : 1];
+    (void)sizeof(_check_unsummarized);
+    return try_emplace(k).first->second;
   }
 
   // Modifiers
@@ -215,6 +280,22 @@ public:
     return _tree.insert_unique(hint, val);
   }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Insert single element, moved from val if it is inserted
+   */
+  ft::pair<iterator, bool> insert(value_type &&val) {
+    return _tree.insert_unique(std::move(val));
+  }
+
+  /**
+   * @brief Insert with hint, moving from val if it is inserted
+   */
+  iterator insert(iterator hint, value_type &&val) {
+    return _tree.insert_unique(hint, std::move(val));
+  }
+#endif
+
   /**
    * @brief Insert multiple elements
    *
@@ -227,6 +308,130 @@ public:
     _tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Insert a sorted range of unique elements
+   *
+   * @param tag ft::sorted_unique, asserting the range is sorted by key_comp()
+   * and has no equivalent keys.
+   * @param first The iterator to the first element in the range.
+   * @param last The iterator to the last element in the range.
+   *
+   * An empty map is built in linear time.
+   */
+  template <class ForwardIterator>
+  void insert(ft::sorted_unique_t tag, ForwardIterator first,
+              ForwardIterator last) {
+    _tree.insert_unique(tag, first, last);
+  }
+
+  /**
+   * @brief Inserts a value constructed in place from the given arguments,
+   * unless an element with an equivalent key already exists.
+   *
+   * Overloads take up to three arguments, forwarded as const references to
+   * the value_type constructor. The value is constructed before its key is
+   * looked up; prefer try_emplace when the key is at hand.
+   *
+   * @return A pair of an iterator to the inserted element (or to the
+   * element that prevented the insertion) and whether the insertion took
+   * place.
+   */
+  ft::pair<iterator, bool> emplace() {
+    return _tree.emplace_unique(ft::make_emplace_args());
+  }
+
+  template <class A1> ft::pair<iterator, bool> emplace(const A1 &a1) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  ft::pair<iterator, bool> emplace(const A1 &a1, const A2 &a2) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  ft::pair<iterator, bool> emplace(const A1 &a1, const A2 &a2,
+                                   const A3 &a3) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Like emplace, with hint as the position the element is expected
+   * to precede.
+   *
+   * @return An iterator to the inserted element, or to the element that
+   * prevented the insertion.
+   */
+  iterator emplace_hint(iterator hint) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args());
+  }
+
+  template <class A1> iterator emplace_hint(iterator hint, const A1 &a1) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2,
+                        const A3 &a3) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Inserts an element with key k and a mapped value constructed in
+   * place from the given arguments, unless the key already exists.
+   *
+   * Overloads take up to three arguments for the mapped_type constructor.
+   * If the key exists, nothing is constructed or copied.
+   *
+   * @return A pair of an iterator to the element with key k and whether the
+   * insertion took place.
+   */
+  ft::pair<iterator, bool> try_emplace(const key_type &k) {
+    return _try_emplace(k, ft::make_emplace_args());
+  }
+
+  template <class A1>
+  ft::pair<iterator, bool> try_emplace(const key_type &k, const A1 &a1) {
+    return _try_emplace(k, ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  ft::pair<iterator, bool> try_emplace(const key_type &k, const A1 &a1,
+                                       const A2 &a2) {
+    return _try_emplace(k, ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  ft::pair<iterator, bool> try_emplace(const key_type &k, const A1 &a1,
+                                       const A2 &a2, const A3 &a3) {
+    return _try_emplace(k, ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Inserts an element with key k and a copy of obj, or assigns obj
+   * to the mapped value if the key already exists.
+   *
+   * The only way to change a mapped value under a policy that summarizes
+   * them, as it keeps the summaries up to date.
+   *
+   * @return A pair of an iterator to the element with key k and whether the
+   * insertion took place.
+   */
+  ft::pair<iterator, bool> insert_or_assign(const key_type &k,
+                                            const mapped_type &obj) {
+    ft::pair<iterator, bool> res = try_emplace(k, obj);
+    if (!res.second) {
+      res.first._node->data.second = obj;
+      _tree.refresh(res.first);
+    }
+    return res;
+  }
+
   /**
    * @brief Erase an element by iterator
    *
@@ -254,6 +459,37 @@ public:
 
   void erase(iterator first, iterator last) { return _tree.erase(first, last); }
 
+  /**
+   * @brief Extract a range of elements
+   *
+   * @param first The iterator to the first element in the range.
+   * @param last The iterator to the element after the range.
+   * @return A map with the same comparison object and allocator, holding
+   * the elements of [first, last), which are removed from this map.
+   *
+   * The nodes are relinked, not copied: the tree is split around the range
+   * in O(log n), plus time linear in the smaller of the two resulting maps.
+   * Iterators into this map are invalidated.
+   */
+  map extract_range(iterator first, iterator last) {
+    map range(key_comp(), get_allocator());
+    _tree.extract_range(first, last, range._tree);
+    return range;
+  }
+
+  /**
+   * @brief Moves the elements of x into this map.
+   *
+   * @param x The other map. Elements whose key is already present in this
+   * map stay in x.
+   *
+   * When the keys of x all go before or all after those of this map, the
+   * two trees are joined in O(log n), plus time linear in the smaller one;
+   * otherwise the elements are moved one at a time. Nothing is copied, and
+   * iterators into both maps are invalidated.
+   */
+  void splice(map &x) { _tree.join(x._tree); }
+
   /**
    * @brief Swap the contents of the container with those of another.
    *
@@ -362,6 +598,54 @@ public:
     return _tree.equal_range(k);
   }
 
+  // Order Statistics
+
+  /**
+   * @brief Count the elements with keys less than k
+   *
+   * Requires a policy that keeps subtree sizes, such as
+   * ft::rb_order_statistic_policy; so do nth() and distance(). Each takes
+   * O(log n).
+   */
+  size_type rank(const key_type &k) const { return _tree.rank(k); }
+
+  /**
+   * @brief Return iterator to the element at index n in key order
+   *
+   * @return An iterator to the element, or end() if n >= size().
+   */
+  iterator nth(size_type n) { return _tree.nth(n); }
+
+  const_iterator nth(size_type n) const { return _tree.nth(n); }
+
+  /**
+   * @brief Return the number of elements from first to last, in O(log n)
+   */
+  difference_type distance(iterator first, iterator last) const {
+    return _tree.distance(first, last);
+  }
+
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return _tree.distance(first, last);
+  }
+
+  // Range Aggregation
+
+  /**
+   * @brief Combine the mapped values of the elements with keys from lo to
+   * hi, both included, in O(log n)
+   *
+   * Requires a policy that keeps a monoid summary, such as
+   * ft::rb_aggregate_policy<ft::sum_monoid<T> >, under which mapped values
+   * change only through insert_or_assign().
+   *
+   * @return The summary of the values in key order, or the identity of the
+   * monoid if no key lies in the range.
+   */
+  summary_type aggregate(const key_type &lo, const key_type &hi) const {
+    return _tree.aggregate(lo, hi);
+  }
+
   // Allocator
 
   /**
@@ -370,48 +654,426 @@ public:
    * @return The allocator object.
    */
   allocator_type get_allocator() const { return _tree.get_allocator(); }
+
+private:
+  // Links the new element in right before the lower bound of k
+  template <class Args>
+  ft::pair<iterator, bool> _try_emplace(const key_type &k, const Args &args) {
+    iterator it = lower_bound(k);
+    if (it != end() && !key_comp()(k, it->first))
+      return ft::make_pair(it, false);
+    it = _tree.emplace_unique(
+        it, ft::make_emplace_args(ft::piecewise_construct, k, args));
+    return ft::make_pair(it, true);
+  }
+};
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator==(const ft::map<Key, T, Compare, Alloc, Policy> &lhs,
+                const ft::map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return lhs.size() == rhs.size() &&
+         ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator!=(const map<Key, T, Compare, Alloc, Policy> &lhs,
+                const map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator<(const map<Key, T, Compare, Alloc, Policy> &lhs,
+               const map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                     rhs.end());
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator>(const map<Key, T, Compare, Alloc, Policy> &lhs,
+               const map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator<=(const map<Key, T, Compare, Alloc, Policy> &lhs,
+                const map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator>=(const map<Key, T, Compare, Alloc, Policy> &lhs,
+                const map<Key, T, Compare, Alloc, Policy> &rhs) {
+  return !(lhs < rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Policy>
+void swap(map<Key, T, Compare, Alloc, Policy> &lhs,
+          map<Key, T, Compare, Alloc, Policy> &rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief A multimap stores key-value pairs ordered by their keys, like map,
+ * but several elements may share a key. Elements with equivalent keys keep
+ * their insertion order.
+ *
+ * Each element is one tree node, so duplicated keys cost no allocation
+ * beyond their own node. equal_range() takes O(log n), count() O(log n + k)
+ * for k equivalent keys, and erasing them O(log n + k).
+ *
+ * @tparam Key The type of the keys.
+ * @tparam T The type of the mapped values.
+ * @tparam Compare The comparison function object type.
+ * @tparam Allocator The allocator type.
+ * @tparam Policy The tree policy, selecting the node layout.
+ */
+template <class Key, class T, class Compare = ft::less<Key>,
+          class Alloc = std::allocator<ft::pair<const Key, T>>,
+          class Policy = ft::rb_default_policy>
+class multimap {
+
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef ft::pair<const Key, T> value_type;
+  typedef Compare key_compare;
+  typedef Alloc allocator_type;
+
+  class value_compare : ft::binary_function<value_type, value_type, bool> {
+    friend class multimap;
+
+  protected:
+    Compare comp;
+    value_compare(Compare c) : comp(c) {}
+
+  public:
+    typedef bool result_type;
+    typedef value_type first_argument_type;
+    typedef value_type second_argument_type;
+    bool operator()(const value_type &x, const value_type &y) const {
+      return comp(x.first, y.first);
+    }
+  };
+
+private:
+  typedef RedBlackTree<Key, T, _Select1st<value_type>, Compare, Alloc, Policy>
+      _tree_type;
+
+public:
+  typedef typename allocator_type::reference reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::pointer pointer;
+  typedef typename allocator_type::const_pointer const_pointer;
+  typedef typename _tree_type::iterator iterator;
+  typedef typename _tree_type::const_iterator const_iterator;
+  typedef typename _tree_type::reverse_iterator reverse_iterator;
+  typedef typename _tree_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _tree_type::size_type size_type;
+  typedef typename iterator_traits<iterator>::difference_type difference_type;
+
+private:
+  _tree_type _tree;
+
+public:
+  // Member Functions
+
+  /**
+   * @brief Empty Container Constructor (Default Constructor)
+   */
+  explicit multimap(const key_compare &comp = key_compare(),
+                    const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {}
+
+  /**
+   * @brief Range Constructor
+   *
+   * Constructs a container with a copy of every element of [first, last),
+   * duplicated keys included.
+   */
+  template <class InputIterator>
+  multimap(InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare(),
+           const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {
+    _tree.insert_equal(first, last);
+  }
+
+  /**
+   * @brief Copy Constructor
+   */
+  multimap(const multimap &x) : _tree(x._tree) {}
+
+  ~multimap() {}
+
+  /**
+   * @brief Copy Assignment Operator
+   */
+  multimap &operator=(const multimap &x) {
+    if (this != &x) {
+      _tree = x._tree;
+    }
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move Constructor. Takes over the nodes of x, leaving it empty.
+   */
+  multimap(multimap &&x) noexcept : _tree(std::move(x._tree)) {}
+
+  /**
+   * @brief Move Assignment Operator. Destroys the current elements and
+   * takes over the nodes of x, leaving it empty.
+   */
+  multimap &operator=(multimap &&x) {
+    _tree = std::move(x._tree);
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() { return _tree.begin(); }
+
+  const_iterator begin() const { return _tree.begin(); }
+
+  iterator end() { return _tree.end(); }
+
+  const_iterator end() const { return _tree.end(); }
+
+  reverse_iterator rbegin() { return _tree.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _tree.rbegin(); }
+
+  reverse_iterator rend() { return _tree.rend(); }
+
+  const_reverse_iterator rend() const { return _tree.rend(); }
+
+  // Capacity
+
+  bool empty() const { return _tree.empty(); }
+
+  size_type size() const { return _tree.size(); }
+
+  size_type max_size() const { return _tree.max_size(); }
+
+  // Modifiers
+
+  /**
+   * @brief Insert single element, after the elements with an equivalent key
+   *
+   * @return An iterator to the inserted element.
+   */
+  iterator insert(const value_type &val) { return _tree.insert_equal(val); }
+
+  /**
+   * @brief Insert with hint, right before hint if the key may go there
+   *
+   * @return An iterator to the inserted element.
+   */
+  iterator insert(iterator hint, const value_type &val) {
+    return _tree.insert_equal(hint, val);
+  }
+
+#if FT_HAS_MOVE
+  iterator insert(value_type &&val) {
+    return _tree.insert_equal(std::move(val));
+  }
+
+  iterator insert(iterator hint, value_type &&val) {
+    return _tree.insert_equal(hint, std::move(val));
+  }
+#endif
+
+  /**
+   * @brief Insert multiple elements; a sorted range is appended with two
+   * comparisons per element
+   */
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    _tree.insert_equal(first, last);
+  }
+
+  /**
+   * @brief Inserts a value constructed in place from the given arguments,
+   * after the elements with an equivalent key.
+   *
+   * Overloads take up to three arguments for the value_type constructor.
+   *
+   * @return An iterator to the inserted element.
+   */
+  iterator emplace() { return _tree.emplace_equal(ft::make_emplace_args()); }
+
+  template <class A1> iterator emplace(const A1 &a1) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2> iterator emplace(const A1 &a1, const A2 &a2) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace(const A1 &a1, const A2 &a2, const A3 &a3) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Like emplace, with hint as the position the element is expected
+   * to precede.
+   */
+  iterator emplace_hint(iterator hint) {
+    return _tree.emplace_equal(hint, ft::make_emplace_args());
+  }
+
+  template <class A1> iterator emplace_hint(iterator hint, const A1 &a1) {
+    return _tree.emplace_equal(hint, ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2) {
+    return _tree.emplace_equal(hint, ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2,
+                        const A3 &a3) {
+    return _tree.emplace_equal(hint, ft::make_emplace_args(a1, a2, a3));
+  }
+
+  void erase(iterator pos) { _tree.erase(pos); }
+
+  /**
+   * @brief Erase every element with a key equivalent to key, in
+   * O(log n + k) for k such elements
+   *
+   * @return The number of elements erased.
+   */
+  size_type erase(const key_type &key) { return _tree.erase(key); }
+
+  void erase(iterator first, iterator last) { _tree.erase(first, last); }
+
+  /**
+   * @brief Extract a range of elements
+   *
+   * @return A multimap with the same comparison object and allocator,
+   * holding the elements of [first, last), which are removed from this one.
+   * The nodes are relinked, not copied, as by map::extract_range.
+   */
+  multimap extract_range(iterator first, iterator last) {
+    multimap range(key_comp(), get_allocator());
+    _tree.extract_range(first, last, range._tree);
+    return range;
+  }
+
+  /**
+   * @brief Moves every element of x into this multimap, after the elements
+   * with equivalent keys already here.
+   *
+   * When the keys of x all go after or with the last key here, or all
+   * before the first, the two trees are joined in O(log n), plus time
+   * linear in the smaller one; otherwise the elements are moved one at a
+   * time. Nothing is copied, and iterators into both are invalidated.
+   */
+  void splice(multimap &x) { _tree.join_equal(x._tree); }
+
+  void swap(multimap &x) { _tree.swap(x._tree); }
+
+  void clear() { _tree.clear(); }
+
+  // Observers
+
+  key_compare key_comp() const { return _tree.key_comp(); }
+
+  value_compare value_comp() const { return value_compare(key_comp()); }
+
+  // Operations
+
+  /**
+   * @brief Find element
+   *
+   * @return An iterator to the first element with a key equivalent to key,
+   * or end() if there is none.
+   */
+  iterator find(const key_type &key) { return _tree.find(key); }
+
+  const_iterator find(const key_type &key) const { return _tree.find(key); }
+
+  /**
+   * @brief Count elements with a specific key, in O(log n + k)
+   */
+  size_type count(const key_type &key) const { return _tree.count_multi(key); }
+
+  iterator lower_bound(const key_type &k) { return _tree.lower_bound(k); }
+
+  const_iterator lower_bound(const key_type &k) const {
+    return _tree.lower_bound(k);
+  }
+
+  iterator upper_bound(const key_type &k) { return _tree.upper_bound(k); }
+
+  const_iterator upper_bound(const key_type &k) const {
+    return _tree.upper_bound(k);
+  }
+
+  /**
+   * @brief Return the range of elements with a key equivalent to k, found
+   * in O(log n) however long it is
+   */
+  ft::pair<iterator, iterator> equal_range(const key_type &k) {
+    return _tree.equal_range_multi(k);
+  }
+
+  ft::pair<const_iterator, const_iterator>
+  equal_range(const key_type &k) const {
+    return _tree.equal_range_multi(k);
+  }
+
+  // Allocator
+
+  allocator_type get_allocator() const { return _tree.get_allocator(); }
 };
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator==(const ft::map<Key, T, Compare, Alloc> &lhs,
-                const ft::map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator==(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+                const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return lhs.size() == rhs.size() &&
          ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator!=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator!=(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+                const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator<(const map<Key, T, Compare, Alloc> &lhs,
-               const map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator<(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+               const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                      rhs.end());
 }
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator>(const map<Key, T, Compare, Alloc> &lhs,
-               const map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator>(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+               const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator<=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator<=(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+                const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare, class Alloc>
-bool operator>=(const map<Key, T, Compare, Alloc> &lhs,
-                const map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+bool operator>=(const multimap<Key, T, Compare, Alloc, Policy> &lhs,
+                const multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   return !(lhs < rhs);
 }
 
-template <class Key, class T, class Compare, class Alloc>
-void swap(map<Key, T, Compare, Alloc> &lhs, map<Key, T, Compare, Alloc> &rhs) {
+template <class Key, class T, class Compare, class Alloc, class Policy>
+void swap(multimap<Key, T, Compare, Alloc, Policy> &lhs,
+          multimap<Key, T, Compare, Alloc, Policy> &rhs) {
   lhs.swap(rhs);
 }
 
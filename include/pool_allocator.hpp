@@ -0,0 +1,408 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include "algorithm.hpp"
+#include "nullptr.hpp"
+#include <cstddef>
+#include <memory>
+
+namespace ft {
+
+/**
+ * @brief Holds the lock on the arenas shared between pools for its
+ * lifetime.
+ *
+ * One lock guards every shared arena. Pools only take it to start a slab,
+ * share, release or take back freed objects, never to allocate or
+ * deallocate a single object, so it is held briefly and rarely. Without
+ * GCC-style atomic builtins, the lock does nothing and shared arenas must
+ * stay on a single thread.
+ */
+class _arena_guard {
+public:
+  _arena_guard() {
+#if defined(__GNUC__) || defined(__clang__)
+    while (__sync_lock_test_and_set(&_word(), 1))
+      while (_word() != 0)
+        ;
+#endif
+  }
+
+  ~_arena_guard() {
+#if defined(__GNUC__) || defined(__clang__)
+    __sync_lock_release(&_word());
+#endif
+  }
+
+private:
+  static volatile int &_word() {
+    static volatile int word = 0;
+    return word;
+  }
+
+  _arena_guard(const _arena_guard &);
+  _arena_guard &operator=(const _arena_guard &);
+};
+
+/**
+ * @brief A slab allocator for fixed-size objects, such as tree nodes.
+ *
+ * Single-object requests are carved out of slabs obtained from the upstream
+ * allocator. Freed objects are pushed onto an intrusive free list and handed
+ * out again before the current slab is touched. Slabs go back upstream only
+ * on release() or destruction, so a pool is meant to be owned by a single
+ * container; copies of a pool start empty, and swap() hands the pooled memory
+ * over with the container. Requests for more than one object bypass the
+ * pool.
+ *
+ * The slabs of a pool form an arena. Containers that move objects between
+ * each other share() their arenas, which are then merged into one that lives
+ * until every pool sharing it has released it. A pool that releases a shared
+ * arena gives its free objects back to it, and pools take those back before
+ * growing, so the arena grows no larger than the objects its pools hold at
+ * once. Pools sharing an arena may be used from different threads.
+ *
+ * @tparam T The object type. It must be at least as large as a pointer.
+ * @tparam Alloc The upstream allocator type.
+ */
+template <class T, class Alloc = std::allocator<T>> class pool_allocator {
+public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef T &reference;
+  typedef const T *const_pointer;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef Alloc upstream_allocator_type;
+
+  template <class U> struct rebind {
+    typedef pool_allocator<U, typename Alloc::template rebind<U>::other> other;
+  };
+
+private:
+  struct _free_block {
+    _free_block *next;
+  };
+
+  // Every slab starts with this header. The arena fields are only used in
+  // the first slab of an arena, which stands for the whole arena, and only
+  // under an _arena_guard.
+  struct _slab {
+    _slab *next;
+    size_type size;         // in objects, header included
+    _slab *slabs;           // all slabs of the arena, most recent first
+    _slab *last;            // the oldest slab, for merging arenas in O(1)
+    size_type refs;         // pools using the arena
+    _slab *merged;          // the arena this one was merged into
+    _free_block *free;      // objects given back by pools that released it
+    _free_block *free_last; // the end of free, for merging arenas in O(1)
+  };
+
+  // Freed objects are reused as free list links
+  typedef char _check_object_size[sizeof(T) >= sizeof(_free_block) ? 1 : -1];
+
+  static const size_type _min_slab_size = 8;
+  static const size_type _max_slab_size = 1024;
+  static const size_type _header_size =
+      (sizeof(_slab) + sizeof(T) - 1) / sizeof(T);
+
+  upstream_allocator_type _upstream;
+  _slab *_arena;           // this pool's arena, or a merged one leading to it
+  _free_block *_free;      // recycled objects
+  _free_block *_free_last; // the oldest one, while there are any
+  pointer _cursor;         // next untouched object in the current slab
+  pointer _end;            // end of the current slab
+  size_type _next_slab_size;
+
+public:
+  // Constructors
+
+  explicit pool_allocator(
+      const upstream_allocator_type &upstream = upstream_allocator_type())
+      : _upstream(upstream), _arena(_nullptr), _free(_nullptr),
+        _free_last(_nullptr), _cursor(_nullptr), _end(_nullptr),
+        _next_slab_size(_min_slab_size) {}
+
+  // Copies share the upstream allocator, never the pooled memory
+  pool_allocator(const pool_allocator &other)
+      : _upstream(other._upstream), _arena(_nullptr), _free(_nullptr),
+        _free_last(_nullptr), _cursor(_nullptr), _end(_nullptr),
+        _next_slab_size(_min_slab_size) {}
+
+  template <class U, class A>
+  pool_allocator(const pool_allocator<U, A> &other)
+      : _upstream(other.upstream()), _arena(_nullptr), _free(_nullptr),
+        _free_last(_nullptr), _cursor(_nullptr), _end(_nullptr),
+        _next_slab_size(_min_slab_size) {}
+
+  ~pool_allocator() { release(); }
+
+  // Allocation
+
+  /**
+   * @brief Allocates storage for n objects.
+   *
+   * @param n The number of objects.
+   * @return A pointer to uninitialized storage. Single objects come from the
+   * free list or the current slab; larger requests go upstream.
+   */
+  pointer allocate(size_type n, const void * = 0) {
+    if (n != 1)
+      return _upstream.allocate(n);
+    if (_free == _nullptr && _cursor == _end && !_take_back())
+      _grow();
+    if (_free != _nullptr) {
+      _free_block *block = _free;
+      _free = block->next;
+      return reinterpret_cast<pointer>(block);
+    }
+    return _cursor++;
+  }
+
+  /**
+   * @brief Returns storage obtained from allocate(n).
+   *
+   * Single objects are kept on the free list for reuse; the slab memory is
+   * not given back until release().
+   */
+  void deallocate(pointer p, size_type n) {
+    if (n != 1) {
+      _upstream.deallocate(p, n);
+      return;
+    }
+    _free_block *block = reinterpret_cast<_free_block *>(p);
+    if (_free == _nullptr)
+      _free_last = block;
+    block->next = _free;
+    _free = block;
+  }
+
+  /**
+   * @brief Makes room for n single-object requests in the current slab.
+   *
+   * While the free list is empty, the next n requests are then served from
+   * consecutive addresses, so that objects allocated in visiting order are
+   * laid out in that order. A slab too small for n is abandoned until
+   * release() in favor of one with room for at least n objects.
+   */
+  void reserve(size_type n) {
+    if (size_type(_end - _cursor) < n)
+      _grow(n);
+  }
+
+  /**
+   * @brief Returns every slab to the upstream allocator, unless the arena is
+   * shared with another pool that still uses it. The free objects of the
+   * pool, and the rest of its current slab, then go back to the arena for
+   * the other pools to reuse.
+   *
+   * All objects handed out by the pool must have been destroyed already or
+   * moved to a pool sharing the arena; the storage of the others becomes
+   * invalid.
+   */
+  void release() {
+    if (_arena != _nullptr) {
+      _slab *slabs = _nullptr;
+      {
+        _arena_guard guard;
+        _slab *arena = _find_arena();
+        if (--arena->refs == 0)
+          slabs = arena->slabs;
+        else
+          _give_back(arena);
+      }
+      while (slabs != _nullptr) {
+        _slab *next = slabs->next;
+        _upstream.deallocate(reinterpret_cast<pointer>(slabs), slabs->size);
+        slabs = next;
+      }
+    }
+    _arena = _nullptr;
+    _free = _nullptr;
+    _cursor = _end = _nullptr;
+    _next_slab_size = _min_slab_size;
+  }
+
+  /**
+   * @brief Returns whether other pools still share the arena of this pool,
+   * in which case objects must be deallocated before release() for the
+   * arena to reuse them.
+   */
+  bool shared() {
+    if (_arena == _nullptr)
+      return false;
+    _arena_guard guard;
+    return _find_arena()->refs > 1;
+  }
+
+  void construct(pointer p, const_reference val) {
+    _upstream.construct(p, val);
+  }
+
+  void destroy(pointer p) { _upstream.destroy(p); }
+
+  size_type max_size() const { return _upstream.max_size(); }
+
+  /**
+   * @brief Makes this pool and other use the same arena, so that objects
+   * allocated by either one may be deallocated by the other.
+   *
+   * The two arenas are merged in constant time, and the slabs of both stay
+   * allocated until both pools, and any other pool sharing either arena,
+   * have released them. The pools must have equal upstream allocators.
+   */
+  void share(pool_allocator &other) {
+    _arena_guard guard;
+    _slab *arena = _find_arena();
+    _slab *other_arena = other._find_arena();
+    if (arena == other_arena)
+      return;
+    if (arena == _nullptr) {
+      _arena = other_arena;
+      ++other_arena->refs;
+      return;
+    }
+    if (other_arena != _nullptr) {
+      arena->last->next = other_arena->slabs;
+      arena->last = other_arena->last;
+      arena->refs += other_arena->refs;
+      if (other_arena->free != _nullptr) {
+        other_arena->free_last->next = arena->free;
+        if (arena->free == _nullptr)
+          arena->free_last = other_arena->free_last;
+        arena->free = other_arena->free;
+      }
+      other_arena->slabs = _nullptr;
+      other_arena->free = _nullptr;
+      other_arena->merged = arena;
+    } else {
+      ++arena->refs;
+    }
+    other._arena = arena;
+  }
+
+  /**
+   * @brief Exchanges the slabs, free lists and upstream allocators of two
+   * pools, so objects allocated by either one now belong to the other.
+   */
+  void swap(pool_allocator &other) {
+    ft::swap(_upstream, other._upstream);
+    ft::swap(_arena, other._arena);
+    ft::swap(_free, other._free);
+    ft::swap(_free_last, other._free_last);
+    ft::swap(_cursor, other._cursor);
+    ft::swap(_end, other._end);
+    ft::swap(_next_slab_size, other._next_slab_size);
+  }
+
+  // Observers
+
+  upstream_allocator_type &upstream() { return _upstream; }
+
+  const upstream_allocator_type &upstream() const { return _upstream; }
+
+private:
+  // Pools own their memory and cannot be assigned
+  pool_allocator &operator=(const pool_allocator &);
+
+  /**
+   * @brief Returns the arena of this pool, following and shortening the
+   * chain of merges that lead to it. Needs an _arena_guard.
+   */
+  _slab *_find_arena() {
+    if (_arena == _nullptr)
+      return _nullptr;
+    _slab *arena = _arena;
+    while (arena->merged != _nullptr)
+      arena = arena->merged;
+    for (_slab *slab = _arena; slab != arena;) {
+      _slab *next = slab->merged;
+      slab->merged = arena;
+      slab = next;
+    }
+    return _arena = arena;
+  }
+
+  /**
+   * @brief Starts a new slab with room for at least n objects, doubling the
+   * regular slab size up to _max_slab_size. The first slab of a pool starts
+   * its arena.
+   */
+  void _grow(size_type n = 0) {
+    size_type objects = n > _next_slab_size ? n : _next_slab_size;
+    size_type size = _header_size + objects;
+    pointer block = _upstream.allocate(size);
+    _slab *slab = reinterpret_cast<_slab *>(block);
+    slab->size = size;
+    slab->merged = _nullptr;
+    _arena_guard guard;
+    _slab *arena = _find_arena();
+    if (arena == _nullptr) {
+      slab->next = _nullptr;
+      slab->slabs = slab;
+      slab->last = slab;
+      slab->refs = 1;
+      slab->free = _nullptr;
+      slab->free_last = _nullptr;
+      _arena = slab;
+    } else {
+      slab->next = arena->slabs;
+      arena->slabs = slab;
+    }
+    _cursor = block + _header_size;
+    _end = block + size;
+    if (_next_slab_size < _max_slab_size)
+      _next_slab_size *= 2;
+  }
+
+  /**
+   * @brief Takes over the objects given back to the arena by the pools that
+   * released it, if there are any.
+   *
+   * @return Whether the free list is no longer empty.
+   */
+  bool _take_back() {
+    if (_arena == _nullptr)
+      return false;
+    _arena_guard guard;
+    _slab *arena = _find_arena();
+    _free = arena->free;
+    _free_last = arena->free_last;
+    arena->free = _nullptr;
+    return _free != _nullptr;
+  }
+
+  /**
+   * @brief Hands the free objects of this pool and the rest of its current
+   * slab over to the arena, which other pools still share. Needs an
+   * _arena_guard.
+   */
+  void _give_back(_slab *arena) {
+    while (_cursor != _end)
+      deallocate(_cursor++, 1);
+    if (_free == _nullptr)
+      return;
+    _free_last->next = arena->free;
+    if (arena->free == _nullptr)
+      arena->free_last = _free_last;
+    arena->free = _free;
+  }
+};
+
+// Pooled memory belongs to a single pool instance
+template <class T1, class A1, class T2, class A2>
+bool operator==(const pool_allocator<T1, A1> &lhs,
+                const pool_allocator<T2, A2> &rhs) {
+  return static_cast<const void *>(&lhs) == static_cast<const void *>(&rhs);
+}
+
+template <class T1, class A1, class T2, class A2>
+bool operator!=(const pool_allocator<T1, A1> &lhs,
+                const pool_allocator<T2, A2> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace ft
+
+#endif
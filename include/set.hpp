@@ -1,6 +1,7 @@
 #ifndef SET_HPP
 #define SET_HPP
 
+#include "config.hpp"
 #include "functional.hpp"
 #include "iterator.hpp"
 #include "tree.hpp"
@@ -8,7 +9,8 @@
 
 namespace ft {
 
-template <class T, class Compare = ft::less<T>, class Alloc = std::allocator<T>>
+template <class T, class Compare = ft::less<T>, class Alloc = std::allocator<T>,
+          class Policy = ft::rb_default_policy>
 class set {
 public:
   typedef T value_type;
@@ -18,7 +20,7 @@ public:
   typedef Alloc allocator_type;
 
 private:
-  typedef RedBlackTree<T, T, _Identity<T>, Compare, Alloc> _tree_type;
+  typedef RedBlackTree<T, T, _Identity<T>, Compare, Alloc, Policy> _tree_type;
 
 public:
   typedef typename allocator_type::reference reference;
@@ -31,6 +33,7 @@ public:
   typedef typename _tree_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _tree_type::size_type size_type;
   typedef typename iterator_traits<iterator>::difference_type difference_type;
+  typedef typename _tree_type::summary_type summary_type;
 
 private:
   _tree_type _tree;
@@ -58,6 +61,18 @@ public:
     _tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Constructs a set in linear time from a range sorted by comp and
+   * free of equivalent values, as asserted by passing ft::sorted_unique.
+   */
+  template <class ForwardIterator>
+  set(ft::sorted_unique_t tag, ForwardIterator first, ForwardIterator last,
+      const key_compare &comp = key_compare(),
+      const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {
+    _tree.insert_unique(tag, first, last);
+  }
+
   /**
    * @brief Copy constructor.
    */
@@ -76,6 +91,22 @@ public:
     return *this;
   }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the nodes of x, leaving it empty.
+   */
+  set(set &&x) noexcept : _tree(std::move(x._tree)) {}
+
+  /**
+   * @brief Move assignment operator. Takes over the nodes of x, leaving it
+   * empty.
+   */
+  set &operator=(set &&x) {
+    _tree = std::move(x._tree);
+    return *this;
+  }
+#endif
+
   // Iterators
 
   /**
@@ -157,6 +188,22 @@ public:
     return _tree.insert_unique(hint, val);
   }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Inserts val, moved from if it is inserted.
+   */
+  ft::pair<iterator, bool> insert(value_type &&val) {
+    return _tree.insert_unique(std::move(val));
+  }
+
+  /**
+   * @brief Inserts val with a hint, moved from if it is inserted.
+   */
+  iterator insert(iterator hint, value_type &&val) {
+    return _tree.insert_unique(hint, std::move(val));
+  }
+#endif
+
   /**
    * @brief Inserts a range of values into the container.
    */
@@ -165,6 +212,72 @@ public:
     _tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Inserts a range sorted by key_comp() and free of equivalent
+   * values, as asserted by passing ft::sorted_unique. An empty set is built
+   * in linear time.
+   */
+  template <class ForwardIterator>
+  void insert(ft::sorted_unique_t tag, ForwardIterator first,
+              ForwardIterator last) {
+    _tree.insert_unique(tag, first, last);
+  }
+
+  /**
+   * @brief Inserts a value constructed in place from the given arguments,
+   * unless an equivalent value already exists.
+   *
+   * Overloads take up to three arguments, forwarded as const references.
+   *
+   * @return A pair of an iterator to the inserted element (or to the
+   * element that prevented the insertion) and whether the insertion took
+   * place.
+   */
+  ft::pair<iterator, bool> emplace() {
+    return _tree.emplace_unique(ft::make_emplace_args());
+  }
+
+  template <class A1> ft::pair<iterator, bool> emplace(const A1 &a1) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  ft::pair<iterator, bool> emplace(const A1 &a1, const A2 &a2) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  ft::pair<iterator, bool> emplace(const A1 &a1, const A2 &a2,
+                                   const A3 &a3) {
+    return _tree.emplace_unique(ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Like emplace, with hint as the position the element is expected
+   * to precede.
+   *
+   * @return An iterator to the inserted element, or to the element that
+   * prevented the insertion.
+   */
+  iterator emplace_hint(iterator hint) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args());
+  }
+
+  template <class A1> iterator emplace_hint(iterator hint, const A1 &a1) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace_hint(iterator hint, const A1 &a1, const A2 &a2,
+                        const A3 &a3) {
+    return _tree.emplace_unique(hint, ft::make_emplace_args(a1, a2, a3));
+  }
+
   /**
    * @brief Removes an element from the container.
    */
@@ -180,6 +293,23 @@ public:
    */
   void erase(iterator first, iterator last) { _tree.erase(first, last); }
 
+  /**
+   * @brief Removes the elements in [first, last) and returns them as a set
+   * with the same comparison object and allocator, without copying them.
+   * See map::extract_range.
+   */
+  set extract_range(iterator first, iterator last) {
+    set range(key_comp(), get_allocator());
+    _tree.extract_range(first, last, range._tree);
+    return range;
+  }
+
+  /**
+   * @brief Moves the elements of x whose keys are missing here into this
+   * set, without copying them. See map::splice.
+   */
+  void splice(set &x) { _tree.join(x._tree); }
+
   /**
    * @brief Swap the contents of the container with those of x.
    */
@@ -246,6 +376,44 @@ public:
     return _tree.equal_range(val);
   }
 
+  // Order statistics, which need a policy that keeps subtree sizes, such as
+  // ft::rb_order_statistic_policy
+
+  /**
+   * @brief Counts the elements less than val, in O(log n).
+   */
+  size_type rank(const value_type &val) const { return _tree.rank(val); }
+
+  /**
+   * @brief Finds the element at index n in order, or end() if n >= size(),
+   * in O(log n).
+   */
+  iterator nth(size_type n) { return _tree.nth(n); }
+
+  const_iterator nth(size_type n) const { return _tree.nth(n); }
+
+  /**
+   * @brief Counts the elements from first to last, in O(log n).
+   */
+  difference_type distance(iterator first, iterator last) const {
+    return _tree.distance(first, last);
+  }
+
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return _tree.distance(first, last);
+  }
+
+  // Range aggregation, which needs a policy that keeps a monoid summary,
+  // such as ft::rb_aggregate_policy<ft::sum_monoid<Key> >
+
+  /**
+   * @brief Combines the elements from lo to hi, both included, in O(log n);
+   * the identity of the monoid if there are none.
+   */
+  summary_type aggregate(const value_type &lo, const value_type &hi) const {
+    return _tree.aggregate(lo, hi);
+  }
+
   // Allocator
 
   /**
@@ -256,46 +424,352 @@ public:
 
 // Non-member function overloads
 
-template <class Key, class Compare, class Alloc>
-bool operator==(const set<Key, Compare, Alloc> &lhs,
-                const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator==(const set<Key, Compare, Alloc, Policy> &lhs,
+                const set<Key, Compare, Alloc, Policy> &rhs) {
+  return lhs.size() == rhs.size() &&
+         ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator!=(const set<Key, Compare, Alloc, Policy> &lhs,
+                const set<Key, Compare, Alloc, Policy> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator<(const set<Key, Compare, Alloc, Policy> &lhs,
+               const set<Key, Compare, Alloc, Policy> &rhs) {
+  return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                     rhs.end(), Compare());
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator<=(const set<Key, Compare, Alloc, Policy> &lhs,
+                const set<Key, Compare, Alloc, Policy> &rhs) {
+  return !(rhs < lhs);
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator>(const set<Key, Compare, Alloc, Policy> &lhs,
+               const set<Key, Compare, Alloc, Policy> &rhs) {
+  return rhs < lhs;
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator>=(const set<Key, Compare, Alloc, Policy> &lhs,
+                const set<Key, Compare, Alloc, Policy> &rhs) {
+  return !(lhs < rhs);
+}
+
+template <class Key, class Compare, class Alloc, class Policy>
+void swap(set<Key, Compare, Alloc, Policy> &lhs,
+          set<Key, Compare, Alloc, Policy> &rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief A multiset keeps its elements ordered like set, but may hold
+ * several equivalent elements, which keep their insertion order.
+ *
+ * equal_range() takes O(log n), count() O(log n + k) for k equivalent
+ * elements, and erasing them O(log n + k).
+ */
+template <class T, class Compare = ft::less<T>, class Alloc = std::allocator<T>,
+          class Policy = ft::rb_default_policy>
+class multiset {
+public:
+  typedef T value_type;
+  typedef T key_type;
+  typedef Compare key_compare;
+  typedef Compare value_compare;
+  typedef Alloc allocator_type;
+
+private:
+  typedef RedBlackTree<T, T, _Identity<T>, Compare, Alloc, Policy> _tree_type;
+
+public:
+  typedef typename allocator_type::reference reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::pointer pointer;
+  typedef typename allocator_type::const_pointer const_pointer;
+  typedef typename _tree_type::iterator iterator;
+  typedef typename _tree_type::const_iterator const_iterator;
+  typedef typename _tree_type::reverse_iterator reverse_iterator;
+  typedef typename _tree_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _tree_type::size_type size_type;
+  typedef typename iterator_traits<iterator>::difference_type difference_type;
+
+private:
+  _tree_type _tree;
+
+public:
+  // Constructors
+
+  /**
+   * @brief Constructs an empty multiset.
+   */
+  explicit multiset(const key_compare &comp = key_compare(),
+                    const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {}
+
+  /**
+   * @brief Constructs a multiset with every element of [first, last).
+   */
+  template <class InputIterator>
+  multiset(InputIterator first, InputIterator last,
+           const key_compare &comp = key_compare(),
+           const allocator_type &alloc = allocator_type())
+      : _tree(comp, alloc) {
+    _tree.insert_equal(first, last);
+  }
+
+  /**
+   * @brief Copy constructor.
+   */
+  multiset(const multiset &x) : _tree(x._tree) {}
+
+  /**
+   * @brief Default destructor.
+   */
+  ~multiset() {}
+
+  /**
+   * @brief Copy assignment operator.
+   */
+  multiset &operator=(const multiset &x) {
+    _tree = x._tree;
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the nodes of x, leaving it empty.
+   */
+  multiset(multiset &&x) noexcept : _tree(std::move(x._tree)) {}
+
+  /**
+   * @brief Move assignment operator. Takes over the nodes of x, leaving it
+   * empty.
+   */
+  multiset &operator=(multiset &&x) {
+    _tree = std::move(x._tree);
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() { return _tree.begin(); }
+
+  const_iterator begin() const { return _tree.begin(); }
+
+  iterator end() { return _tree.end(); }
+
+  const_iterator end() const { return _tree.end(); }
+
+  reverse_iterator rbegin() { return _tree.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _tree.rbegin(); }
+
+  reverse_iterator rend() { return _tree.rend(); }
+
+  const_reverse_iterator rend() const { return _tree.rend(); }
+
+  // Capacity
+
+  bool empty() const { return _tree.empty(); }
+
+  size_type size() const { return _tree.size(); }
+
+  size_type max_size() const { return _tree.max_size(); }
+
+  // Modifiers
+
+  /**
+   * @brief Inserts a value after the equivalent values already present.
+   */
+  iterator insert(const value_type &val) { return _tree.insert_equal(val); }
+
+  /**
+   * @brief Inserts a value right before hint if it may go there.
+   */
+  iterator insert(iterator hint, const value_type &val) {
+    return _tree.insert_equal(hint, val);
+  }
+
+#if FT_HAS_MOVE
+  iterator insert(value_type &&val) {
+    return _tree.insert_equal(std::move(val));
+  }
+
+  iterator insert(iterator hint, value_type &&val) {
+    return _tree.insert_equal(hint, std::move(val));
+  }
+#endif
+
+  /**
+   * @brief Inserts a range of values into the container.
+   */
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    _tree.insert_equal(first, last);
+  }
+
+  /**
+   * @brief Inserts a value constructed in place from the given arguments,
+   * after the equivalent values already present.
+   *
+   * Overloads take up to three arguments, forwarded as const references.
+   */
+  iterator emplace() { return _tree.emplace_equal(ft::make_emplace_args()); }
+
+  template <class A1> iterator emplace(const A1 &a1) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2> iterator emplace(const A1 &a1, const A2 &a2) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace(const A1 &a1, const A2 &a2, const A3 &a3) {
+    return _tree.emplace_equal(ft::make_emplace_args(a1, a2, a3));
+  }
+
+  /**
+   * @brief Removes an element from the container.
+   */
+  void erase(iterator pos) { _tree.erase(pos); }
+
+  /**
+   * @brief Removes every element equivalent to key, in O(log n + k).
+   */
+  size_type erase(const key_type &key) { return _tree.erase(key); }
+
+  /**
+   * @brief Removes a range of elements from the container.
+   */
+  void erase(iterator first, iterator last) { _tree.erase(first, last); }
+
+  /**
+   * @brief Removes the elements in [first, last) and returns them as a
+   * multiset, without copying them. See map::extract_range.
+   */
+  multiset extract_range(iterator first, iterator last) {
+    multiset range(key_comp(), get_allocator());
+    _tree.extract_range(first, last, range._tree);
+    return range;
+  }
+
+  /**
+   * @brief Moves every element of x into this multiset, after the
+   * equivalent elements already here. See multimap::splice.
+   */
+  void splice(multiset &x) { _tree.join_equal(x._tree); }
+
+  /**
+   * @brief Swap the contents of the container with those of x.
+   */
+  void swap(multiset &x) { _tree.swap(x._tree); }
+
+  /**
+   * @brief Removes all elements from the container.
+   */
+  void clear() { _tree.clear(); }
+
+  // Observers
+
+  key_compare key_comp() const { return _tree.key_comp(); }
+
+  value_compare value_comp() const { return _tree.key_comp(); }
+
+  // Operations
+
+  /**
+   * @brief Finds the first element equivalent to val.
+   */
+  iterator find(const value_type &val) { return _tree.find(val); }
+
+  const_iterator find(const value_type &val) const { return _tree.find(val); }
+
+  /**
+   * @brief Counts the elements equivalent to val, in O(log n + k).
+   */
+  size_type count(const value_type &val) const {
+    return _tree.count_multi(val);
+  }
+
+  iterator lower_bound(const value_type &val) { return _tree.lower_bound(val); }
+
+  const_iterator lower_bound(const value_type &val) const {
+    return _tree.lower_bound(val);
+  }
+
+  iterator upper_bound(const value_type &val) { return _tree.upper_bound(val); }
+
+  const_iterator upper_bound(const value_type &val) const {
+    return _tree.upper_bound(val);
+  }
+
+  /**
+   * @brief Finds the range of elements equivalent to val, in O(log n).
+   */
+  ft::pair<iterator, iterator> equal_range(const value_type &val) {
+    return _tree.equal_range_multi(val);
+  }
+
+  ft::pair<const_iterator, const_iterator>
+  equal_range(const value_type &val) const {
+    return _tree.equal_range_multi(val);
+  }
+
+  // Allocator
+
+  allocator_type get_allocator() const { return _tree.get_allocator(); }
+};
+
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator==(const multiset<Key, Compare, Alloc, Policy> &lhs,
+                const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return lhs.size() == rhs.size() &&
          ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class Key, class Compare, class Alloc>
-bool operator!=(const set<Key, Compare, Alloc> &lhs,
-                const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator!=(const multiset<Key, Compare, Alloc, Policy> &lhs,
+                const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare, class Alloc>
-bool operator<(const set<Key, Compare, Alloc> &lhs,
-               const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator<(const multiset<Key, Compare, Alloc, Policy> &lhs,
+               const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                      rhs.end(), Compare());
 }
 
-template <class Key, class Compare, class Alloc>
-bool operator<=(const set<Key, Compare, Alloc> &lhs,
-                const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator<=(const multiset<Key, Compare, Alloc, Policy> &lhs,
+                const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare, class Alloc>
-bool operator>(const set<Key, Compare, Alloc> &lhs,
-               const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator>(const multiset<Key, Compare, Alloc, Policy> &lhs,
+               const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return rhs < lhs;
 }
 
-template <class Key, class Compare, class Alloc>
-bool operator>=(const set<Key, Compare, Alloc> &lhs,
-                const set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+bool operator>=(const multiset<Key, Compare, Alloc, Policy> &lhs,
+                const multiset<Key, Compare, Alloc, Policy> &rhs) {
   return !(lhs < rhs);
 }
 
-template <class Key, class Compare, class Alloc>
-void swap(set<Key, Compare, Alloc> &lhs, set<Key, Compare, Alloc> &rhs) {
+template <class Key, class Compare, class Alloc, class Policy>
+void swap(multiset<Key, Compare, Alloc, Policy> &lhs,
+          multiset<Key, Compare, Alloc, Policy> &rhs) {
   lhs.swap(rhs);
 }
 
@@ -0,0 +1,132 @@
+#ifndef SMALL_BUFFER_ALLOCATOR_HPP
+#define SMALL_BUFFER_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace ft {
+
+/**
+ * @brief An allocator that embeds room for N objects in itself.
+ *
+ * The first request for at most N objects is served from the inline buffer;
+ * every other request, and any request made while the buffer is taken, goes
+ * to the upstream allocator. The buffer is meant for a single container that
+ * owns the allocator, so copies of an allocator start with a free buffer.
+ *
+ * @tparam T The object type.
+ * @tparam N The number of objects the inline buffer holds.
+ * @tparam Alloc The upstream allocator type.
+ */
+template <class T, std::size_t N, class Alloc = std::allocator<T>>
+class small_buffer_allocator {
+public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef T &reference;
+  typedef const T *const_pointer;
+  typedef const T &const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef Alloc upstream_allocator_type;
+
+  template <class U> struct rebind {
+    typedef small_buffer_allocator<U, N,
+                                   typename Alloc::template rebind<U>::other>
+        other;
+  };
+
+private:
+  // Raw storage aligned for any fundamental type
+  union _storage {
+    char bytes[N * sizeof(T)];
+    long double ld;
+    long long ll;
+    void *p;
+  };
+
+  upstream_allocator_type _upstream;
+  bool _in_use;
+  _storage _buffer;
+
+public:
+  // Constructors
+
+  explicit small_buffer_allocator(
+      const upstream_allocator_type &upstream = upstream_allocator_type())
+      : _upstream(upstream), _in_use(false) {}
+
+  // Copies share the upstream allocator, never the inline buffer
+  small_buffer_allocator(const small_buffer_allocator &other)
+      : _upstream(other._upstream), _in_use(false) {}
+
+  template <class U, class A>
+  small_buffer_allocator(const small_buffer_allocator<U, N, A> &other)
+      : _upstream(other.upstream()), _in_use(false) {}
+
+  small_buffer_allocator &operator=(const small_buffer_allocator &other) {
+    _upstream = other._upstream;
+    return *this;
+  }
+
+  // Allocation
+
+  /**
+   * @brief Allocates storage for n objects, from the inline buffer if it is
+   * free and large enough.
+   */
+  pointer allocate(size_type n, const void * = 0) {
+    if (n <= N && !_in_use) {
+      _in_use = true;
+      return reinterpret_cast<pointer>(_buffer.bytes);
+    }
+    return _upstream.allocate(n);
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (owns(p))
+      _in_use = false;
+    else
+      _upstream.deallocate(p, n);
+  }
+
+  void construct(pointer p, const_reference val) {
+    _upstream.construct(p, val);
+  }
+
+  void destroy(pointer p) { _upstream.destroy(p); }
+
+  size_type max_size() const { return _upstream.max_size(); }
+
+  // Observers
+
+  /**
+   * @brief Whether p points to the inline buffer.
+   */
+  bool owns(const_pointer p) const {
+    return p == reinterpret_cast<const_pointer>(_buffer.bytes);
+  }
+
+  upstream_allocator_type &upstream() { return _upstream; }
+
+  const upstream_allocator_type &upstream() const { return _upstream; }
+};
+
+// Inline storage belongs to a single allocator instance
+template <class T1, std::size_t N1, class A1, class T2, std::size_t N2,
+          class A2>
+bool operator==(const small_buffer_allocator<T1, N1, A1> &lhs,
+                const small_buffer_allocator<T2, N2, A2> &rhs) {
+  return static_cast<const void *>(&lhs) == static_cast<const void *>(&rhs);
+}
+
+template <class T1, std::size_t N1, class A1, class T2, std::size_t N2,
+          class A2>
+bool operator!=(const small_buffer_allocator<T1, N1, A1> &lhs,
+                const small_buffer_allocator<T2, N2, A2> &rhs) {
+  return !(lhs == rhs);
+}
+
+} // namespace ft
+
+#endif
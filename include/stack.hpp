@@ -1,6 +1,7 @@
 #ifndef STACK_HPP
 #define STACK_HPP
 
+#include "config.hpp"
 #include "vector.hpp"
 
 namespace ft {
@@ -57,10 +58,24 @@ public:
    */
   void push(const value_type &value) { _container.push_back(value); }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Push an element onto the stack, moved from value
+   */
+  void push(value_type &&value) { _container.push_back(std::move(value)); }
+#endif
+
   /**
    * @brief Pop an element off the stack
    */
   void pop() { _container.pop_back(); }
+
+  /**
+   * @brief Swap the underlying containers of two stacks
+   *
+   * @param other The stack to swap with
+   */
+  void swap(stack &other) { ft::swap(_container, other._container); }
 };
 
 template <class T, class Container>
@@ -97,6 +112,11 @@ bool operator>=(const stack<T, Container> &lhs,
   return !(lhs < rhs);
 }
 
+template <class T, class Container>
+void swap(stack<T, Container> &lhs, stack<T, Container> &rhs) {
+  lhs.swap(rhs);
+}
+
 } // namespace ft
 
 #endif
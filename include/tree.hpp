@@ -2,115 +2,311 @@
 #define TREE_HPP
 
 #include "algorithm.hpp"
+#include "config.hpp"
 #include "functional.hpp"
 #include "iterator.hpp"
 #include "nullptr.hpp"
+#include "pool_allocator.hpp"
+#include "type_traits.hpp"
 #include "utility.hpp"
+#include <climits>
 #include <cstddef>
+#include <limits>
 #include <memory>
 
 namespace ft {
 
 enum color { RED, BLACK };
 
-template <class T, class Alloc = std::allocator<T>> class Node {
+/**
+ * @brief Augmentations keep a summary of each subtree in its root node.
+ *
+ * A node type derives from its augmentation, which supplies the summary
+ * fields and a static update(x, nil) that recomputes the summary of x from
+ * its value and the summaries of its children, nil standing for an empty
+ * subtree. The tree calls it wherever a subtree changes. rb_no_augment is
+ * empty and disabled, so that unaugmented trees compile all of it out.
+ *
+ * Augmentations that can be aggregated over a key range name the type of
+ * their summary as summary_type; the others declare it void.
+ */
+struct rb_no_augment {
+  static const bool enabled = false;
+
+  typedef void summary_type;
+
+  template <class NodePtr> static void update(NodePtr, NodePtr) {}
+};
+
+/**
+ * @brief Keeps the number of nodes in each subtree, for order statistics:
+ * rank(), nth() and distance() in O(log n).
+ */
+struct rb_size_augment {
+  static const bool enabled = true;
+
+  typedef void summary_type;
+
+  std::size_t size; // nodes in the subtree rooted here
+
+  template <class NodePtr> static void update(NodePtr x, NodePtr nil) {
+    x->size = subtree_size(x->left, nil) + 1 + subtree_size(x->right, nil);
+  }
+
+  template <class NodePtr>
+  static std::size_t subtree_size(NodePtr x, NodePtr nil) {
+    return x == nil ? 0 : x->size;
+  }
+};
+
+/**
+ * @brief Keeps a monoid summary of the values in each subtree, for range
+ * aggregation in O(log n).
+ *
+ * Monoid is a default-constructible function object with a result_type and
+ * three members: identity(), the summary of no value; lift(value), the
+ * summary of one stored value; and combine(a, b), an associative operation
+ * on summaries, a covering keys that precede those of b. Summaries live in
+ * raw node storage, so result_type must be trivially copyable.
+ */
+template <class Monoid> struct rb_monoid_augment {
+  static const bool enabled = true;
+
+  typedef Monoid monoid_type;
+  typedef typename Monoid::result_type summary_type;
+
+  summary_type summary; // the values of the subtree rooted here, combined
+
+  template <class NodePtr> static void update(NodePtr x, NodePtr nil) {
+    Monoid m;
+    x->summary = m.combine(m.combine(subtree_summary(x->left, nil),
+                                     m.lift(x->data)),
+                           subtree_summary(x->right, nil));
+  }
+
+  template <class NodePtr>
+  static summary_type subtree_summary(NodePtr x, NodePtr nil) {
+    return x == nil ? Monoid().identity() : x->summary;
+  }
+
+private:
+  typedef char _check_summary_type
+      [ft::is_trivially_copyable<summary_type>::value ? 1 : -1];
+};
+
+// The part of a stored value that the monoids below summarize: the mapped
+// value of a map element, or a set element itself
+template <class T> const T &_summarized(const T &value) { return value; }
+
+template <class K, class T> const T &_summarized(const ft::pair<K, T> &value) {
+  return value.second;
+}
+
+/**
+ * @brief Monoids for rb_monoid_augment over values of an arithmetic type T:
+ * the sum, the minimum and the maximum of the values in a range.
+ */
+template <class T> struct sum_monoid {
+  typedef T result_type;
+
+  T identity() const { return T(); }
+
+  template <class Value> T lift(const Value &value) const {
+    return _summarized(value);
+  }
+
+  T combine(const T &a, const T &b) const { return a + b; }
+};
+
+template <class T> struct min_monoid {
+  typedef T result_type;
+
+  T identity() const { return std::numeric_limits<T>::max(); }
+
+  template <class Value> T lift(const Value &value) const {
+    return _summarized(value);
+  }
+
+  T combine(const T &a, const T &b) const { return b < a ? b : a; }
+};
+
+template <class T> struct max_monoid {
+  typedef T result_type;
+
+  T identity() const {
+    return std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min()
+                                              : -std::numeric_limits<T>::max();
+  }
+
+  template <class Value> T lift(const Value &value) const {
+    return _summarized(value);
+  }
+
+  T combine(const T &a, const T &b) const { return a < b ? b : a; }
+};
+
+/**
+ * @brief A red-black tree node.
+ *
+ * The value is stored inline, so a node costs a single allocation. The tree
+ * allocates raw node storage through its rebound allocator and constructs
+ * only the value field in place; the sentinel node never holds a value.
+ *
+ * Tree code reaches the parent link and the color through the accessors, so
+ * that alternative layouts such as CompactNode can be swapped in.
+ *
+ * @tparam T The type of the stored value.
+ * @tparam Augment The subtree summary kept in the node, if any.
+ */
+template <class T, class Augment = rb_no_augment>
+class Node : public Augment {
 public:
   typedef T value_type;
   typedef T *pointer;
   typedef T &reference;
   typedef const T *const_pointer;
   typedef const T &const_reference;
-  typedef Node<T> *node_ptr;
-  typedef Alloc allocator_type;
+  typedef Node<T, Augment> *node_ptr;
   typedef enum color color_type;
+  typedef Augment augment_type;
 
   // Properties
   node_ptr parent;
   node_ptr left;
   node_ptr right;
-  node_ptr aux;
   color_type color;
-  pointer data;
-  allocator_type alloc;
+  value_type data;
 
 public:
   // Default Constructor
   explicit Node(color_type color = BLACK, node_ptr parent = _nullptr,
-                node_ptr left = _nullptr, node_ptr right = _nullptr,
-                allocator_type alloc = allocator_type())
-      : data(_nullptr), parent(parent), left(left), right(right), color(color),
-        alloc(alloc) {}
+                node_ptr left = _nullptr, node_ptr right = _nullptr)
+      : parent(parent), left(left), right(right), color(color), data() {}
 
   // Value constructor
-  Node(value_type v, color_type color, node_ptr nil,
-       allocator_type alloc = allocator_type())
-      : alloc(alloc), parent(nil), left(nil), right(nil), color(color) {
-    data = alloc.allocate(1);
-    alloc.construct(data, v);
+  Node(const value_type &v, color_type color, node_ptr nil)
+      : parent(nil), left(nil), right(nil), color(color), data(v) {}
+
+  // Link all three pointers to link and set the color, on raw storage
+  void init(node_ptr link, color_type c) {
+    parent = left = right = link;
+    color = c;
   }
 
-  // Copy constructor
-  Node(const Node &n)
-      : parent(n.parent), left(n.left), right(n.right), color(n.color),
-        alloc(n.alloc) {
-    data = alloc.allocate(1);
-    if (n.data != _nullptr)
-      alloc.construct(data, *n.data);
+  // Accessors
+
+  node_ptr get_parent() const { return parent; }
+
+  void set_parent(node_ptr p) { parent = p; }
+
+  color_type get_color() const { return color; }
+
+  void set_color(color_type c) { color = c; }
+};
+
+/**
+ * @brief A red-black tree node with the color packed into the parent link.
+ *
+ * Nodes are at least pointer-aligned, so the lowest bit of the parent
+ * address is always zero and can hold the color instead. This saves the
+ * padded color word of Node, 8 bytes per node on LP64 targets.
+ *
+ * @tparam T The type of the stored value.
+ * @tparam Augment The subtree summary kept in the node, if any.
+ */
+template <class T, class Augment = rb_no_augment>
+class CompactNode : public Augment {
+public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef T &reference;
+  typedef const T *const_pointer;
+  typedef const T &const_reference;
+  typedef CompactNode<T, Augment> *node_ptr;
+  typedef enum color color_type;
+  typedef Augment augment_type;
+
+  // Properties
+  node_ptr left;
+  node_ptr right;
+
+private:
+  std::size_t _parent_color; // parent address | color bit
+
+public:
+  value_type data;
+
+public:
+  // Link all three pointers to link and set the color, on raw storage
+  void init(node_ptr link, color_type c) {
+    left = right = link;
+    _parent_color = reinterpret_cast<std::size_t>(link) | c;
   }
 
-  // Copy assignment operator
-  Node &operator=(const Node &node) {
-    if (this != &node) {
-      if (node.data != _nullptr) {
-        if (data != _nullptr) {
-          alloc.destroy(data);
-          alloc.deallocate(data, 1);
-        }
-        data = alloc.allocate(1);
-        alloc.construct(data, *node.data);
-      } else {
-        if (data != _nullptr) {
-          alloc.destroy(data);
-          alloc.deallocate(data, 1);
-        }
-        data = _nullptr;
-      }
-      parent = node.parent;
-      left = node.left;
-      right = node.right;
-      color = node.color;
-    }
-    return *this;
+  // Accessors
+
+  node_ptr get_parent() const {
+    return reinterpret_cast<node_ptr>(_parent_color & ~std::size_t(1));
   }
 
-  // Default destructor
-  virtual ~Node() {
-    if (data != _nullptr) {
-      alloc.destroy(data);
-    }
-    alloc.deallocate(data, 1);
+  void set_parent(node_ptr p) {
+    _parent_color = reinterpret_cast<std::size_t>(p) | (_parent_color & 1);
   }
 
-  // Getters
+  color_type get_color() const {
+    return static_cast<color_type>(_parent_color & 1);
+  }
+
+  void set_color(color_type c) {
+    _parent_color = (_parent_color & ~std::size_t(1)) | c;
+  }
+};
 
-  // reference data() { return *data; }
+/**
+ * @brief Tree policies select the node layout of a RedBlackTree.
+ *
+ * rb_default_policy stores the color in its own field; rb_compact_policy
+ * packs it into the parent pointer for denser nodes, at the cost of a mask
+ * on every parent access. The augmented policies add a subtree summary to
+ * either layout, and rb_order_statistic_policy keeps subtree sizes.
+ * rb_aggregate_policy<Monoid> keeps a Monoid summary of each subtree.
+ */
+struct rb_default_policy {
+  template <class T> struct rebind { typedef Node<T> other; };
+};
+
+struct rb_compact_policy {
+  template <class T> struct rebind { typedef CompactNode<T> other; };
+};
+
+template <class Augment> struct rb_augmented_policy {
+  template <class T> struct rebind { typedef Node<T, Augment> other; };
+};
+
+template <class Augment> struct rb_compact_augmented_policy {
+  template <class T> struct rebind { typedef CompactNode<T, Augment> other; };
+};
 
-  // const_reference data() const { return *data; }
+typedef rb_augmented_policy<rb_size_augment> rb_order_statistic_policy;
+
+template <class Monoid>
+struct rb_aggregate_policy : rb_augmented_policy<rb_monoid_augment<Monoid>> {
 };
 
-template <class T>
+// Iterates over mutable values, or over read-only ones when ReadOnly is set
+template <class T, class NodeType = Node<T>, bool ReadOnly = false>
 class TreeIterator : public ft::iterator<ft::bidirectional_iterator_tag, T> {
 public:
   typedef T value_type;
-  typedef T *pointer;
-  typedef T &reference;
+  typedef typename ft::conditional<ReadOnly, const T *, T *>::type pointer;
+  typedef typename ft::conditional<ReadOnly, const T &, T &>::type reference;
 
   typedef ft::bidirectional_iterator_tag iterator_category;
   typedef ft::ptrdiff_t difference_type;
 
-  typedef TreeIterator<T> self;
-  typedef typename Node<T>::node_ptr node_ptr;
-  typedef Node<T> *link_type;
+  typedef TreeIterator<T, NodeType, ReadOnly> self;
+  typedef typename NodeType::node_ptr node_ptr;
+  typedef NodeType *link_type;
 
   node_ptr _node;
 
@@ -122,9 +318,9 @@ public:
 
   TreeIterator(node_ptr node, node_ptr leaf) : _node(node), _leaf(leaf) {}
 
-  TreeIterator(const TreeIterator<T> &it) : _node(it._node), _leaf(it._leaf) {}
+  TreeIterator(const self &it) : _node(it._node), _leaf(it._leaf) {}
 
-  self &operator=(const TreeIterator<T> &it) {
+  self &operator=(const self &it) {
     if (this != &it) {
       _node = it._node;
       _leaf = it._leaf;
@@ -132,7 +328,7 @@ public:
     return *this;
   }
 
-  reference operator*() const { return *_node->data; }
+  reference operator*() const { return _node->data; }
 
   pointer operator->() const { return &(operator*()); }
 
@@ -151,24 +347,24 @@ public:
   node_ptr _successor(node_ptr x) {
     if (x->right != _leaf)
       return _minimum(x->right);
-    node_ptr y = x->parent;
+    node_ptr y = x->get_parent();
     while (y != _leaf && x == y->right) {
       x = y;
-      y = y->parent;
+      y = y->get_parent();
     }
     return y;
   }
 
   node_ptr _predecessor(node_ptr x) {
     if (x == _leaf) {
-      return _leaf->aux;
+      return _leaf->right;
     }
     if (x->left != _leaf)
       return _maximum(x->left);
-    node_ptr y = x->parent;
+    node_ptr y = x->get_parent();
     while (y != _leaf && x == y->left) {
       x = y;
-      y = y->parent;
+      y = y->get_parent();
     }
     return y;
   }
@@ -200,7 +396,7 @@ public:
   bool operator!=(const self &it) const { return _node != it._node; }
 };
 
-template <class T> class TreeConstIterator {
+template <class T, class NodeType = Node<T>> class TreeConstIterator {
 public:
   typedef T value_type;
   typedef T *pointer;
@@ -209,9 +405,9 @@ public:
   typedef ft::bidirectional_iterator_tag iterator_category;
   typedef ft::ptrdiff_t difference_type;
 
-  typedef TreeConstIterator<T> self;
-  typedef typename Node<T>::node_ptr node_ptr;
-  typedef Node<T> *link_type;
+  typedef TreeConstIterator<T, NodeType> self;
+  typedef typename NodeType::node_ptr node_ptr;
+  typedef NodeType *link_type;
 
   node_ptr _node;
 
@@ -224,10 +420,9 @@ public:
   TreeConstIterator(node_ptr node, node_ptr leaf = _nullptr)
       : _node(node), _leaf(leaf) {}
 
-  TreeConstIterator(const TreeConstIterator<T> &it)
-      : _node(it._node), _leaf(it._leaf) {}
+  TreeConstIterator(const self &it) : _node(it._node), _leaf(it._leaf) {}
 
-  self &operator=(const TreeConstIterator<T> &it) {
+  self &operator=(const self &it) {
     if (this != &it) {
       _node = it._node;
       _leaf = it._leaf;
@@ -235,7 +430,7 @@ public:
     return *this;
   }
 
-  reference operator*() const { return *_node->data; }
+  reference operator*() const { return _node->data; }
 
   pointer operator->() const { return &(operator*()); }
 
@@ -254,24 +449,24 @@ public:
   node_ptr _successor(node_ptr x) {
     if (x->right != _leaf)
       return _minimum(x->right);
-    node_ptr y = x->parent;
+    node_ptr y = x->get_parent();
     while (y != _leaf && x == y->right) {
       x = y;
-      y = y->parent;
+      y = y->get_parent();
     }
     return y;
   }
 
   node_ptr _predecessor(node_ptr x) {
     if (x == _leaf) {
-      return _leaf->aux;
+      return _leaf->right;
     }
     if (x->left != _leaf)
       return _maximum(x->left);
-    node_ptr y = x->parent;
+    node_ptr y = x->get_parent();
     while (y != _leaf && x == y->left) {
       x = y;
-      y = y->parent;
+      y = y->get_parent();
     }
     return y;
   }
@@ -303,20 +498,23 @@ public:
   bool operator!=(const self &it) const { return _node != it._node; }
 };
 
-template <class T>
-inline bool operator==(const TreeIterator<T> &it1,
-                       const TreeConstIterator<T> &it2) {
+template <class T, class NodeType>
+inline bool operator==(const TreeIterator<T, NodeType> &it1,
+                       const TreeConstIterator<T, NodeType> &it2) {
   return *it1 == *it2;
 }
 
-template <class T>
-inline bool operator!=(const TreeIterator<T> &it1,
-                       const TreeConstIterator<T> &it2) {
+template <class T, class NodeType>
+inline bool operator!=(const TreeIterator<T, NodeType> &it1,
+                       const TreeConstIterator<T, NodeType> &it2) {
   return !(it1 == it2);
 }
 
+// ReadOnlyValues makes iterator read-only, for owners whose summaries cover
+// the whole value and must see every write
 template <class Key, class T, class KeyOfValue, class Compare = ft::less<Key>,
-          class Alloc = std::allocator<ft::pair<const Key, T>>>
+          class Alloc = std::allocator<ft::pair<const Key, T>>,
+          class Policy = rb_default_policy, bool ReadOnlyValues = false>
 class RedBlackTree {
 public:
   typedef Key key_type;
@@ -328,16 +526,21 @@ public:
   typedef Compare key_compare;
   typedef const T *const_pointer;
   typedef const T &const_reference;
-  typedef Node<value_type, allocator_type> node_type;
+  typedef Policy policy_type;
+  typedef typename Policy::template rebind<value_type>::other node_type;
   typedef node_type *node_ptr;
+  typedef typename node_type::augment_type augment_type;
+  typedef typename augment_type::summary_type summary_type;
   typedef node_type const &node_ref;
   typedef std::size_t size_type;
   typedef ptrdiff_t difference_type;
-  typedef TreeIterator<value_type> iterator;
-  typedef TreeConstIterator<value_type> const_iterator;
+  typedef TreeIterator<value_type, node_type, ReadOnlyValues> iterator;
+  typedef TreeConstIterator<value_type, node_type> const_iterator;
   typedef ft::reverse_iterator<iterator> reverse_iterator;
   typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
-  typedef std::allocator<node_type> node_allocator_type;
+  typedef pool_allocator<node_type,
+                         typename Alloc::template rebind<node_type>::other>
+      node_allocator_type;
 
 private:
   size_type _size;
@@ -347,49 +550,88 @@ private:
 
   // Aux Nodes
   node_ptr _root;
+  // Sentinel; _nil->left and _nil->right cache the minimum and maximum
+  // nodes, and point back to _nil when the tree is empty
   node_ptr _nil;
 
+  // A red-black tree of n nodes is at most 2 log2(n + 1) levels deep
+  static const size_type _max_height = 2 * sizeof(size_type) * CHAR_BIT;
+
+  // Ranges longer than this are erased by splitting the tree, shorter
+  // ones node by node, which is cheaper than the splits and the join
+  static const size_type _min_split_erase = 16;
+
+  // A source node awaiting its copy in _copy_tree
+  struct _copy_frame {
+    node_ptr source;
+    node_ptr left;   // copy of source->left, once made
+    node_ptr parent; // copy of the parent if source is a right child
+  };
+
 public:
   // Default constructor
   explicit RedBlackTree(const key_compare &comp = key_compare(),
                         const allocator_type &alloc = allocator_type())
-      : _node_alloc(node_allocator_type()), _alloc(alloc), _comp(comp),
-        _size(0) {
-    _nil = _node_alloc.allocate(1);
-    _node_alloc.construct(_nil, node_type());
-    _nil->parent = _nil->left = _nil->right = _nil;
+      : _size(0), _alloc(alloc),
+        _node_alloc(
+            typename node_allocator_type::upstream_allocator_type(alloc)),
+        _comp(comp) {
+    _nil = _new_nil();
     _root = _nil;
   }
 
   // Copy constructor
   RedBlackTree(const RedBlackTree &tree)
-      : _node_alloc(node_allocator_type(tree._node_alloc)),
-        _alloc(allocator_type(tree._alloc)), _comp(tree._comp),
-        _size(tree._size) {
-    _nil = _node_alloc.allocate(1);
-    _nil->parent = _nil->left = _nil->right = _nil;
-    _node_alloc.construct(_nil, node_type());
-    _root = _copy_tree(tree._root, tree._nil);
-    _nil->aux = _maximum(_root);
+      : _size(0), _alloc(tree._alloc), _node_alloc(tree._node_alloc),
+        _comp(tree._comp) {
+    _nil = _new_nil();
+    _root = _nil;
+    try {
+      _copy_from(tree);
+    } catch (...) {
+      _node_alloc.upstream().deallocate(_nil, 1);
+      throw;
+    }
   }
 
+#if FT_HAS_MOVE
+  // Move constructor; tree is left empty on the shared sentinel, so that
+  // nothing is allocated
+  RedBlackTree(RedBlackTree &&tree) noexcept
+      : _size(0), _alloc(tree._alloc), _node_alloc(tree._node_alloc),
+        _comp(tree._comp), _root(_shared_nil()), _nil(_root) {
+    swap(tree);
+  }
+#endif
+
   // Destructor
   virtual ~RedBlackTree() {
     clear();
-    _node_alloc.destroy(_nil);
-    _node_alloc.deallocate(_nil, 1);
+    if (_nil != _shared_nil())
+      _node_alloc.upstream().deallocate(_nil, 1);
   }
 
   // Copy assignment operator
   RedBlackTree &operator=(const RedBlackTree &tree) {
     if (this != &tree) {
-      _destroy_tree(_root);
-      _root = _copy_tree(tree._root, tree._nil);
-      _size = tree._size;
+      clear();
+      _copy_from(tree);
     }
     return *this;
   }
 
+#if FT_HAS_MOVE
+  // Move assignment operator; takes over the nodes of tree, which is left
+  // empty
+  RedBlackTree &operator=(RedBlackTree &&tree) {
+    if (this != &tree) {
+      clear();
+      swap(tree);
+    }
+    return *this;
+  }
+#endif
+
   // Getters
 
   node_ptr get_root() const { return _root; }
@@ -406,9 +648,9 @@ public:
 
   // Iterators
 
-  iterator begin() { return iterator(_minimum(_root), _nil); }
+  iterator begin() { return iterator(_nil->left, _nil); }
 
-  const_iterator begin() const { return const_iterator(_minimum(_root), _nil); }
+  const_iterator begin() const { return const_iterator(_nil->left, _nil); }
 
   iterator end() { return iterator(_nil, _nil); }
 
@@ -433,26 +675,163 @@ public:
   }
 
   iterator insert_unique(iterator hint, const value_type &val) {
-    (void)hint;
-    ft::pair<iterator, bool> p = _insert(val);
-    return p.first;
+    return _insert_hint(hint._node, val);
   }
 
+  /* @brief Constructs a value in a new node from args, an
+   * ft::make_emplace_args result, and links it in unless its key is taken.
+   * The node is built before the key is known, so a duplicate key costs a
+   * construction that is immediately undone.
+   */
+  template <class Args>
+  ft::pair<iterator, bool> emplace_unique(const Args &args) {
+    node_ptr z = _emplace_node(args);
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(_key(z), parent, left);
+    if (x != _nil) {
+      _destroy_node(z);
+      return ft::make_pair(iterator(x, _nil), false);
+    }
+    return ft::make_pair(_link_node(parent, left, z), true);
+  }
+
+  template <class Args>
+  iterator emplace_unique(iterator hint, const Args &args) {
+    node_ptr z = _emplace_node(args);
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(hint._node, _key(z), parent, left);
+    if (x != _nil) {
+      _destroy_node(z);
+      return iterator(x, _nil);
+    }
+    return _link_node(parent, left, z);
+  }
+
+#if FT_HAS_MOVE
+  // The key is looked up first, so val is only moved from if it is inserted
+  ft::pair<iterator, bool> insert_unique(value_type &&val) {
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(_key(val), parent, left);
+    if (x != _nil)
+      return ft::make_pair(iterator(x, _nil), false);
+    node_ptr z = _emplace_node(ft::make_emplace_move_args(val));
+    return ft::make_pair(_link_node(parent, left, z), true);
+  }
+
+  iterator insert_unique(iterator hint, value_type &&val) {
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(hint._node, _key(val), parent, left);
+    if (x != _nil)
+      return iterator(x, _nil);
+    node_ptr z = _emplace_node(ft::make_emplace_move_args(val));
+    return _link_node(parent, left, z);
+  }
+#endif
+
   template <class InputIterator>
   void insert_unique(InputIterator first, InputIterator last) {
     for (; first != last; ++first) {
-      _insert(*first);
+      _insert_hint(_nil, *first);
     }
   }
 
+  /* @brief Inserts a sorted range of unique values.
+   *
+   * An empty tree is built bottom-up in linear time, without comparisons or
+   * rotations. Otherwise each value is inserted with end() as the hint.
+   */
+  template <class ForwardIterator>
+  void insert_unique(ft::sorted_unique_t, ForwardIterator first,
+                     ForwardIterator last) {
+    if (!empty()) {
+      insert_unique(first, last);
+      return;
+    }
+    size_type n = 0;
+    for (ForwardIterator it = first; it != last; ++it)
+      ++n;
+    if (n == 0)
+      return;
+    _own_nil();
+    _root = _build_tree(first, n, 0, _red_depth(n));
+    _root->set_parent(_nil);
+    _nil->left = _minimum(_root);
+    _nil->right = _maximum(_root);
+    _size = n;
+  }
+
+  // Equal-key insertion, for multimap and multiset. A value goes after the
+  // elements with an equivalent key, unless a hint places it before one
+
+  iterator insert_equal(const value_type &val) {
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(_key(val), parent, left);
+    return _insert_at(parent, left, val);
+  }
+
+  iterator insert_equal(iterator hint, const value_type &val) {
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(hint._node, _key(val), parent, left);
+    return _insert_at(parent, left, val);
+  }
+
+  template <class Args> iterator emplace_equal(const Args &args) {
+    node_ptr z = _emplace_node(args);
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(_key(z), parent, left);
+    return _link_node(parent, left, z);
+  }
+
+  template <class Args>
+  iterator emplace_equal(iterator hint, const Args &args) {
+    node_ptr z = _emplace_node(args);
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(hint._node, _key(z), parent, left);
+    return _link_node(parent, left, z);
+  }
+
+#if FT_HAS_MOVE
+  iterator insert_equal(value_type &&val) {
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(_key(val), parent, left);
+    return _link_node(parent, left,
+                      _emplace_node(ft::make_emplace_move_args(val)));
+  }
+
+  iterator insert_equal(iterator hint, value_type &&val) {
+    node_ptr parent;
+    bool left;
+    _insert_equal_pos(hint._node, _key(val), parent, left);
+    return _link_node(parent, left,
+                      _emplace_node(ft::make_emplace_move_args(val)));
+  }
+#endif
+
+  // A sorted range is appended with two comparisons per value
+  template <class InputIterator>
+  void insert_equal(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert_equal(end(), *first);
+  }
+
   void erase(iterator position) {
     if (position == end())
       return;
     _erase_aux(position);
   }
 
+  // Erases every element with a key equivalent to key
   size_type erase(const key_type &key) {
-    ft::pair<iterator, iterator> p = equal_range(key);
+    ft::pair<iterator, iterator> p = equal_range_multi(key);
     const size_type old_size = size();
     _erase_aux(p.first, p.second);
     return old_size - size();
@@ -460,15 +839,143 @@ public:
 
   void erase(iterator first, iterator last) { _erase_aux(first, last); }
 
+  /* @brief Moves the elements whose keys are not less than key into right,
+   * replacing its contents. See extract_range.
+   */
+  void split(const key_type &key, RedBlackTree &right) {
+    extract_range(lower_bound(key), end(), right);
+  }
+
+  /* @brief Moves the elements in [first, last) into out, replacing its
+   * contents.
+   *
+   * No element is copied. The tree is split around the range and the rest
+   * joined back in O(log n). Counting the range and pointing the leaves of
+   * the smaller of the two trees at its new sentinel adds O(min(k, n - k))
+   * for a range of k elements. The node pools of both trees are shared from
+   * then on, so that nodes freed by either are reused by both, and the trees
+   * may still be used from different threads. Iterators into either tree are
+   * invalidated.
+   */
+  void extract_range(iterator first, iterator last, RedBlackTree &out) {
+    out.clear();
+    if (first == last)
+      return;
+    if (first == begin() && last == end()) {
+      swap(out);
+      return;
+    }
+    out._own_nil();
+    node_ptr min = first._node == _nil->left ? last._node : _nil->left;
+    node_ptr max = _nil->right;
+    if (last._node == _nil)
+      max = (--iterator(first))._node;
+    node_ptr out_max = (--iterator(last))._node;
+    node_ptr left, right = _nil, middle;
+    size_type left_height, right_height = 0, middle_height;
+    if (last._node != _nil)
+      _split(last._node, left, left_height, right, right_height);
+    _split(first._node, left, left_height, middle, middle_height);
+    middle = _join(_nil, 0, first._node, middle, middle_height, middle_height);
+    if (last._node != _nil)
+      left = _join(left, left_height, last._node, right, right_height,
+                   left_height);
+    bool middle_smaller;
+    size_type moved = _smaller_size(middle, left, middle_smaller);
+    if (!middle_smaller)
+      moved = _size - moved;
+    out._node_alloc.share(_node_alloc);
+    _root = left;
+    out._root = middle;
+    _size -= moved;
+    out._size = moved;
+    if (middle_smaller) {
+      _relink(out._root, _nil, out._nil);
+    } else {
+      _relink(_root, _nil, out._nil);
+      ft::swap(_nil, out._nil);
+    }
+    _nil->left = min;
+    _nil->right = max;
+    out._nil->left = first._node;
+    out._nil->right = out_max;
+  }
+
+  /* @brief Moves the elements of other into this tree.
+   *
+   * If the keys of other all go after those of this tree, or all before,
+   * the trees are joined around the nearest node of other in O(log n), plus
+   * O(min(n, m)) to point the leaves of the smaller tree at the sentinel of
+   * the other. Otherwise the nodes of other are moved over one at a time,
+   * and those whose key is already present stay in other. No element is
+   * copied; the node pools of both trees are shared from then on, as for
+   * extract_range, and iterators into either tree are invalidated.
+   */
+  void join(RedBlackTree &other) {
+    if (this == &other || other.empty())
+      return;
+    if (empty()) {
+      swap(other);
+      return;
+    }
+    _node_alloc.share(other._node_alloc);
+    if (_comp(_key(_nil->right), _key(other._nil->left))) {
+      _append(other);
+    } else if (_comp(_key(other._nil->right), _key(_nil->left))) {
+      swap(other);
+      _append(other);
+    } else {
+      _merge(other, false);
+    }
+  }
+
+  /* @brief Moves every element of other into this tree, as join does for
+   * unique keys. Keys equivalent to some in this tree are kept and go after
+   * them, so the trees are joined in O(log n) whenever the keys of other
+   * all go after or with the last key of this tree, or all before the
+   * first.
+   */
+  void join_equal(RedBlackTree &other) {
+    if (this == &other || other.empty())
+      return;
+    if (empty()) {
+      swap(other);
+      return;
+    }
+    _node_alloc.share(other._node_alloc);
+    if (!_comp(_key(other._nil->left), _key(_nil->right))) {
+      _append(other);
+    } else if (_comp(_key(other._nil->right), _key(_nil->left))) {
+      swap(other);
+      _append(other);
+    } else {
+      _merge(other, true);
+    }
+  }
+
+  // Exchanges the node pools and sentinels, so no node is copied and
+  // iterators keep pointing to their elements in the other tree
   void swap(RedBlackTree &tree) {
-    RedBlackTree<Key, T, KeyOfValue, Compare, Alloc> tmp(tree);
-    tree = *this;
-    *this = tmp;
+    ft::swap(_size, tree._size);
+    ft::swap(_alloc, tree._alloc);
+    _node_alloc.swap(tree._node_alloc);
+    ft::swap(_comp, tree._comp);
+    ft::swap(_root, tree._root);
+    ft::swap(_nil, tree._nil);
   }
 
+  // Trivially destructible values need no visit: releasing the pool frees
+  // every node at once, unless other trees share it and reuse the nodes
   void clear() {
-    _destroy_tree(_root);
+    if (!ft::is_trivially_destructible<value_type>::value ||
+        _node_alloc.shared())
+      _destroy_tree(_root);
+    _node_alloc.release();
     _root = _nil;
+    if (_nil != _shared_nil()) {
+      _nil->left = _nil;
+      _nil->right = _nil;
+    }
     _size = 0;
   }
 
@@ -504,13 +1011,133 @@ public:
     return const_iterator(_upper_bound(key), _nil);
   }
 
+  // Keys are unique, so the range holds at most the lower bound. Trees
+  // filled by insert_equal use equal_range_multi and count_multi instead
   ft::pair<iterator, iterator> equal_range(const key_type &key) {
-    return ft::make_pair(lower_bound(key), upper_bound(key));
+    iterator first = lower_bound(key);
+    iterator last = first;
+    if (first._node != _nil && !_comp(key, _key(first._node)))
+      ++last;
+    return ft::make_pair(first, last);
   }
 
   ft::pair<const_iterator, const_iterator>
   equal_range(const key_type &key) const {
-    return ft::make_pair(lower_bound(key), upper_bound(key));
+    const_iterator first = lower_bound(key);
+    const_iterator last = first;
+    if (first._node != _nil && !_comp(key, _key(first._node)))
+      ++last;
+    return ft::make_pair(first, last);
+  }
+
+  ft::pair<iterator, iterator> equal_range_multi(const key_type &key) {
+    ft::pair<node_ptr, node_ptr> range = _equal_range(key);
+    return ft::make_pair(iterator(range.first, _nil),
+                         iterator(range.second, _nil));
+  }
+
+  ft::pair<const_iterator, const_iterator>
+  equal_range_multi(const key_type &key) const {
+    ft::pair<node_ptr, node_ptr> range = _equal_range(key);
+    return ft::make_pair(const_iterator(range.first, _nil),
+                         const_iterator(range.second, _nil));
+  }
+
+  // Takes O(log n + k) for k equivalent keys
+  size_type count_multi(const key_type &key) const {
+    ft::pair<node_ptr, node_ptr> range = _equal_range(key);
+    size_type n = 0;
+    for (const_iterator it(range.first, _nil); it._node != range.second; ++it)
+      ++n;
+    return n;
+  }
+
+  // Order statistics, for policies that keep subtree sizes, such as
+  // rb_order_statistic_policy
+
+  // Returns the number of elements whose keys are less than key
+  size_type rank(const key_type &key) const {
+    size_type rank = 0;
+    node_ptr x = _root;
+    while (x != _nil) {
+      if (_comp(_key(x), key)) {
+        rank += augment_type::subtree_size(x->left, _nil) + 1;
+        x = x->right;
+      } else {
+        x = x->left;
+      }
+    }
+    return rank;
+  }
+
+  // Returns the element at index k in key order, or end() if there is none
+  iterator nth(size_type k) { return iterator(_nth(k), _nil); }
+
+  const_iterator nth(size_type k) const {
+    return const_iterator(_nth(k), _nil);
+  }
+
+  // Returns what ft::distance(first, last) would, in O(log n)
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return difference_type(_index(last._node)) -
+           difference_type(_index(first._node));
+  }
+
+  difference_type distance(iterator first, iterator last) const {
+    return difference_type(_index(last._node)) -
+           difference_type(_index(first._node));
+  }
+
+  // Range aggregation, for policies that keep a monoid summary, such as
+  // rb_aggregate_policy
+
+  // Recomputes the summaries that cover pos, after its value was modified
+  // in place; a no-op without augmentation
+  void refresh(iterator pos) { _update_path(pos._node); }
+
+  /* @brief Returns the values of the elements with keys from lo to hi, both
+   * included, combined in key order; the identity if there are none.
+   *
+   * Descends to the highest node in the range, then once down each side of
+   * it, combining the summaries of the subtrees that lie wholly inside.
+   */
+  summary_type aggregate(const key_type &lo, const key_type &hi) const {
+    typename augment_type::monoid_type m;
+    node_ptr x = _root;
+    while (x != _nil) {
+      if (_comp(_key(x), lo))
+        x = x->right;
+      else if (_comp(hi, _key(x)))
+        x = x->left;
+      else
+        break;
+    }
+    if (x == _nil)
+      return m.identity();
+    summary_type left = m.identity();
+    for (node_ptr y = x->left; y != _nil;) {
+      if (_comp(_key(y), lo)) {
+        y = y->right;
+      } else {
+        left = m.combine(
+            m.combine(m.lift(y->data),
+                      augment_type::subtree_summary(y->right, _nil)),
+            left);
+        y = y->left;
+      }
+    }
+    summary_type right = m.identity();
+    for (node_ptr y = x->right; y != _nil;) {
+      if (_comp(hi, _key(y))) {
+        y = y->left;
+      } else {
+        right = m.combine(
+            right, m.combine(augment_type::subtree_summary(y->left, _nil),
+                             m.lift(y->data)));
+        y = y->right;
+      }
+    }
+    return m.combine(m.combine(left, m.lift(x->data)), right);
   }
 
   allocator_type get_allocator() const { return allocator_type(_alloc); }
@@ -518,19 +1145,89 @@ public:
 private:
   // Private methods
 
-  const key_type _key(node_ptr node) const {
-    return KeyOfValue()(*(node->data));
+  const key_type &_key(node_ptr node) const {
+    return KeyOfValue()(node->data);
   }
 
-  const key_type _key(value_type val) const { return KeyOfValue()(val); }
+  const key_type &_key(const value_type &val) const {
+    return KeyOfValue()(val);
+  }
 
+  /* @brief Allocate a node and construct its value in place.
+   * @param value The value to copy into the node.
+   * @param color The color of the new node.
+   * @return The new node, with both children and parent set to nil.
+   */
   node_ptr _new_node(const value_type &value,
                      const typename node_type::color_type color = RED) {
     node_ptr z = _node_alloc.allocate(1);
-    _node_alloc.construct(z, node_type(value, color, _nil, _alloc));
+    try {
+      _alloc.construct(&z->data, value);
+    } catch (...) {
+      _node_alloc.deallocate(z, 1);
+      throw;
+    }
+    z->init(_nil, color);
+    return z;
+  }
+
+  /* @brief Allocate a node and construct its value from emplace arguments.
+   * @param args An ft::make_emplace_args result.
+   * @return The new red node, with both children and parent set to nil.
+   */
+  template <class Args> node_ptr _emplace_node(const Args &args) {
+    node_ptr z = _node_alloc.allocate(1);
+    try {
+      args.construct(&z->data);
+    } catch (...) {
+      _node_alloc.deallocate(z, 1);
+      throw;
+    }
+    z->init(_nil, RED);
     return z;
   }
 
+  /* @brief Allocate the sentinel node. Its value field is never constructed.
+   * The sentinel outlives clear(), so it bypasses the node pool.
+   * @return The new sentinel, linked to itself.
+   */
+  node_ptr _new_nil() {
+    node_ptr nil = _node_alloc.upstream().allocate(1);
+    nil->init(nil, BLACK);
+    return nil;
+  }
+
+  // Raw storage for a sentinel, linked to itself on construction
+  struct _nil_storage {
+    union {
+      char bytes[sizeof(node_type)];
+      void *align_pointer;
+      long double align_float;
+      long long align_integer;
+    } u;
+
+    _nil_storage() { node()->init(node(), BLACK); }
+
+    node_ptr node() { return reinterpret_cast<node_ptr>(u.bytes); }
+  };
+
+  /* @brief The sentinel of the trees left empty by a move, shared by all
+   * trees of this type so that moving allocates nothing. It is never
+   * written to: a tree takes its own sentinel before linking in a node.
+   */
+  static node_ptr _shared_nil() {
+    static _nil_storage storage;
+    return storage.node();
+  }
+
+  // Replaces the shared sentinel of an empty tree with one of its own
+  void _own_nil() {
+    if (_nil == _shared_nil()) {
+      _nil = _new_nil();
+      _root = _nil;
+    }
+  }
+
   /* @brief Get the node with the minimum value in the subtree rooted at node.
    * @param node The root of the subtree.
    * @return The node with the minimum value in the subtree rooted at node.
@@ -561,22 +1258,44 @@ private:
    * @param value The value to find
    * @return The node with the given value. If the value is not found,
    * return the nil node
+   *
+   * Descends to the lower bound with one comparison per level, then checks
+   * it for equivalence with a single extra comparison.
    */
   node_ptr _find(const key_type &k) const {
-    node_ptr node;
-
-    node = _root;
-    while (node != _nil) {
-      if (!(_comp(k, _key(node)) || _comp(_key(node), k)))
-        return node;
-      else if (_comp(k, _key(node)))
-        node = node->left;
-      else
-        node = node->right;
+    node_ptr node = _lower_bound(k);
+    if (node == _nil || _comp(k, _key(node)))
+      return _nil;
+    return node;
+  }
+
+  node_ptr _nth(size_type k) const {
+    node_ptr x = _root;
+    while (x != _nil) {
+      size_type left = augment_type::subtree_size(x->left, _nil);
+      if (k == left)
+        return x;
+      if (k < left) {
+        x = x->left;
+      } else {
+        k -= left + 1;
+        x = x->right;
+      }
     }
     return _nil;
   }
 
+  // Returns the position of x in key order, size() for the sentinel
+  size_type _index(node_ptr x) const {
+    if (x == _nil)
+      return _size;
+    size_type index = augment_type::subtree_size(x->left, _nil);
+    for (node_ptr p = x->get_parent(); p != _nil; x = p, p = p->get_parent())
+      if (x == p->right)
+        index += augment_type::subtree_size(p->left, _nil) + 1;
+    return index;
+  }
+
   node_ptr _lower_bound(const key_type &key) const {
     node_ptr x = _root;
     node_ptr y = _nil;
@@ -589,6 +1308,46 @@ private:
     return y;
   }
 
+  /* @brief Returns the lower and upper bounds of key.
+   *
+   * Both bounds share the descent down to the first node with an equivalent
+   * key; from there the lower bound lies in its left subtree and the upper
+   * bound in its right one, so the search takes O(log n) however many keys
+   * are equivalent.
+   */
+  ft::pair<node_ptr, node_ptr> _equal_range(const key_type &key) const {
+    node_ptr x = _root;
+    node_ptr upper = _nil;
+    while (x != _nil) {
+      if (_comp(key, _key(x))) {
+        upper = x;
+        x = x->left;
+      } else if (_comp(_key(x), key)) {
+        x = x->right;
+      } else {
+        node_ptr lower = x;
+        for (node_ptr y = x->left; y != _nil;) {
+          if (_comp(_key(y), key)) {
+            y = y->right;
+          } else {
+            lower = y;
+            y = y->left;
+          }
+        }
+        for (node_ptr y = x->right; y != _nil;) {
+          if (_comp(key, _key(y))) {
+            upper = y;
+            y = y->left;
+          } else {
+            y = y->right;
+          }
+        }
+        return ft::make_pair(lower, upper);
+      }
+    }
+    return ft::make_pair(upper, upper);
+  }
+
   node_ptr _upper_bound(const key_type &key) const {
     node_ptr x = _root;
     node_ptr y = _nil;
@@ -601,29 +1360,128 @@ private:
     return y;
   }
 
-  /*
-   * @brief: Deep copy tree
+  /* @brief Depth at which a tree built by _build_tree has its red nodes.
+   *
+   * Splitting at the median fills every level above floor(log2(n + 1)).
+   * Coloring the nodes of that last, partial level red and every other node
+   * black gives all paths the same black height.
+   */
+  static size_type _red_depth(size_type n) {
+    size_type depth = 0;
+    for (++n; n > 1; n >>= 1)
+      ++depth;
+    return depth;
+  }
+
+  /* @brief Builds a balanced subtree from the next n values of a sorted range.
    *
-   * @param:
-   *  node: root of the tree to copy
-   *  nil: nil node of the tree to copy
+   * @param first The next value to consume; advanced past the subtree.
+   * @param n The number of values in the subtree.
+   * @param depth The depth of the subtree root.
+   * @param red_depth The depth whose nodes are colored red.
+   * @return The subtree root, whose parent link is left for the caller.
    *
-   * @return:
-   *  root of the copied tree
+   * If a value fails to copy, the nodes built so far are destroyed before
+   * the exception propagates, as the tree does not link them in yet.
    */
-  node_ptr _copy_tree(const node_ptr &node, const node_ptr &tree_copy_nil) {
-    if (node == tree_copy_nil)
+  template <class ForwardIterator>
+  node_ptr _build_tree(ForwardIterator &first, size_type n, size_type depth,
+                       size_type red_depth) {
+    if (n == 0)
       return _nil;
-    node_ptr new_node = _node_alloc.allocate(1);
-    _node_alloc.construct(new_node, *node);
-    new_node->left = _copy_tree(node->left, tree_copy_nil);
-    new_node->right = _copy_tree(node->right, tree_copy_nil);
-    new_node->parent = _nil;
-    if (new_node->left != _nil)
-      new_node->left->parent = new_node;
-    if (new_node->right != _nil)
-      new_node->right->parent = new_node;
-    return new_node;
+    size_type left_size = (n - 1) / 2;
+    node_ptr left = _build_tree(first, left_size, depth + 1, red_depth);
+    node_ptr node = _nil;
+    try {
+      node = _new_node(*first, depth == red_depth ? RED : BLACK);
+      node->left = left;
+      if (left != _nil)
+        left->set_parent(node);
+      ++first;
+      node->right =
+          _build_tree(first, n - 1 - left_size, depth + 1, red_depth);
+    } catch (...) {
+      _destroy_tree(node != _nil ? node : left);
+      throw;
+    }
+    if (node->right != _nil)
+      node->right->set_parent(node);
+    augment_type::update(node, _nil);
+    return node;
+  }
+
+  /* @brief Copies the elements and shape of tree into this empty tree.
+   *
+   * All nodes are reserved up front, so the copy is laid out in one
+   * contiguous slab, in order.
+   */
+  void _copy_from(const RedBlackTree &tree) {
+    _own_nil();
+    _node_alloc.reserve(tree._size);
+    _root = _copy_tree(tree._root, tree._nil);
+    _size = tree._size;
+    _nil->left = _minimum(_root);
+    _nil->right = _maximum(_root);
+  }
+
+  /* @brief Deep copies a tree, creating the nodes in in-order sequence.
+   *
+   * @param root The root of the tree to copy.
+   * @param nil The sentinel of the tree to copy.
+   * @return The root of the copy, whose parent is this tree's sentinel.
+   *
+   * The source is walked in order with an explicit stack of the nodes whose
+   * left subtree is being copied, which never holds more than the height of
+   * the tree. Each copy is linked below the copy of its parent if that
+   * exists already, that is for right children, and is otherwise left on
+   * the parent's stack entry. If a copy throws, the nodes created so far are
+   * destroyed.
+   */
+  node_ptr _copy_tree(node_ptr root, node_ptr nil) {
+    _copy_frame stack[_max_height];
+    size_type top = 0;
+    node_ptr copy = _nil;
+    _push_left_path(stack, top, root, nil, _nil);
+    try {
+      while (top > 0) {
+        _copy_frame &frame = stack[top - 1];
+        node_ptr z = _new_node(frame.source->data, frame.source->get_color());
+        node_ptr source = frame.source;
+        static_cast<augment_type &>(*z) = *source;
+        z->left = frame.left;
+        if (z->left != _nil)
+          z->left->set_parent(z);
+        if (frame.parent != _nil) {
+          frame.parent->right = z;
+          z->set_parent(frame.parent);
+        } else if (top > 1) {
+          stack[top - 2].left = z;
+        } else {
+          copy = z;
+        }
+        --top;
+        _push_left_path(stack, top, source->right, nil, z);
+      }
+    } catch (...) {
+      for (size_type i = 0; i < top; i++)
+        _destroy_tree(stack[i].left);
+      _destroy_tree(copy);
+      throw;
+    }
+    return copy;
+  }
+
+  /* @brief Pushes node and its chain of left descendants onto the stack of
+   * _copy_tree. Only node itself can be a right child, of parent.
+   */
+  void _push_left_path(_copy_frame *stack, size_type &top, node_ptr node,
+                       node_ptr nil, node_ptr parent) {
+    for (; node != nil; node = node->left, parent = _nil) {
+      stack[top].source = node;
+      stack[top].left = _nil;
+      stack[top].parent = parent;
+      ++top;
+    }
   }
 
   /* @brief Inserts a new node with the given key and mapped value.
@@ -646,92 +1504,276 @@ private:
    */
 
   ft::pair<iterator, bool> _insert(const value_type &val) {
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(_key(val), parent, left);
+    if (x != _nil)
+      return ft::make_pair(iterator(x, _nil), false);
+    return ft::make_pair(_insert_at(parent, left, val), true);
+  }
+
+  /* @brief Inserts a value next to a hinted position.
+   *
+   * @param pos The node the value is expected to precede, or nil for end().
+   * @param val The value to insert.
+   * @return An iterator to the inserted node, or to the node with an
+   * equivalent key.
+   */
+  iterator _insert_hint(node_ptr pos, const value_type &val) {
+    node_ptr parent;
+    bool left;
+    node_ptr x = _insert_pos(pos, _key(val), parent, left);
+    if (x != _nil)
+      return iterator(x, _nil);
+    return _insert_at(parent, left, val);
+  }
+
+  /* @brief Finds the free child slot a new key belongs in.
+   *
+   * Descends as a lower bound search, with one comparison per level, then
+   * checks the last node not less than k for equivalence.
+   *
+   * @param k The key.
+   * @param parent Set to the parent of the slot, or nil if the tree is empty.
+   * @param left Set to whether the slot is the left child of parent.
+   * @return The node with a key equivalent to k, or nil if there is none.
+   */
+  node_ptr _insert_pos(const key_type &k, node_ptr &parent, bool &left) const {
     node_ptr y = _nil;
     node_ptr x = _root;
+    node_ptr bound = _nil;
+    left = false;
     while (x != _nil) {
       y = x;
-      if (!_comp(_key(val), _key(x)) && !_comp(_key(x), _key(val))) {
-        _nil->aux = _maximum(_root);
-        return ft::make_pair(iterator(x, _nil), false);
-      } else if (_comp(_key(val), _key(x)))
+      left = !_comp(_key(x), k);
+      if (left) {
+        bound = x;
         x = x->left;
-      else
+      } else {
         x = x->right;
+      }
+    }
+    parent = y;
+    if (bound != _nil && !_comp(k, _key(bound)))
+      return bound;
+    return _nil;
+  }
+
+  /* @brief Finds the free child slot a new key belongs in, next to a hinted
+   * position.
+   *
+   * @param pos The node the key is expected to precede, or nil for end().
+   *
+   * If k belongs right before pos, the slot is found with at most two
+   * comparisons, as either the left child of pos or the right child of its
+   * predecessor (one of which is always free). A wrong hint falls back to
+   * the regular root-to-leaf search.
+   */
+  node_ptr _insert_pos(node_ptr pos, const key_type &k, node_ptr &parent,
+                       bool &left) const {
+    if (pos == _nil) {
+      if (_size > 0 && _comp(_key(_nil->right), k))
+        return parent = _nil->right, left = false, _nil;
+      return _insert_pos(k, parent, left);
     }
-    node_ptr z = _new_node(val);
-    z->parent = y;
-    if (y == _nil)
+    if (_comp(k, _key(pos))) {
+      if (pos == _nil->left)
+        return parent = pos, left = true, _nil;
+      const_iterator before(pos, _nil);
+      --before;
+      if (_comp(_key(before._node), k)) {
+        if (before._node->right == _nil)
+          return parent = before._node, left = false, _nil;
+        return parent = pos, left = true, _nil;
+      }
+      return _insert_pos(k, parent, left);
+    }
+    if (_comp(_key(pos), k)) {
+      if (pos == _nil->right)
+        return parent = pos, left = false, _nil;
+      const_iterator after(pos, _nil);
+      ++after;
+      if (_comp(k, _key(after._node))) {
+        if (pos->right == _nil)
+          return parent = pos, left = false, _nil;
+        return parent = after._node, left = true, _nil;
+      }
+      return _insert_pos(k, parent, left);
+    }
+    parent = pos;
+    left = false;
+    return pos;
+  }
+
+  /* @brief Finds the free child slot a new key belongs in, after the
+   * equivalent keys already present.
+   */
+  void _insert_equal_pos(const key_type &k, node_ptr &parent,
+                         bool &left) const {
+    node_ptr y = _nil;
+    node_ptr x = _root;
+    left = false;
+    while (x != _nil) {
+      y = x;
+      left = _comp(k, _key(x));
+      x = left ? x->left : x->right;
+    }
+    parent = y;
+  }
+
+  /* @brief Finds the free child slot for k right before pos, or nil for
+   * end(), if k may go there; otherwise after the equivalent keys already
+   * present, as for a wrong hint to _insert_pos.
+   */
+  void _insert_equal_pos(node_ptr pos, const key_type &k, node_ptr &parent,
+                         bool &left) const {
+    if (pos == _nil) {
+      if (_size > 0 && !_comp(k, _key(_nil->right))) {
+        parent = _nil->right;
+        left = false;
+        return;
+      }
+    } else if (!_comp(_key(pos), k)) {
+      if (pos == _nil->left) {
+        parent = pos;
+        left = true;
+        return;
+      }
+      const_iterator before(pos, _nil);
+      --before;
+      if (!_comp(k, _key(before._node))) {
+        if (before._node->right == _nil) {
+          parent = before._node;
+          left = false;
+        } else {
+          parent = pos;
+          left = true;
+        }
+        return;
+      }
+    }
+    _insert_equal_pos(k, parent, left);
+  }
+
+  /* @brief Links a new node as a leaf below parent and rebalances.
+   *
+   * @param parent The parent of the new node, or nil if the tree is empty.
+   * @param left Whether the node becomes the left child of parent. The
+   * chosen child slot must be free and keep the tree ordered.
+   * @param val The value of the new node.
+   * @return An iterator to the new node.
+   */
+  iterator _insert_at(node_ptr parent, bool left, const value_type &val) {
+    return _link_node(parent, left, _new_node(val));
+  }
+
+  /* @brief Links the detached node z in as a leaf below parent and
+   * rebalances, as for _insert_at.
+   */
+  iterator _link_node(node_ptr parent, bool left, node_ptr z) {
+    if (parent == _nil && _nil == _shared_nil()) {
+      try {
+        _own_nil();
+      } catch (...) {
+        _destroy_node(z);
+        throw;
+      }
+      z->init(_nil, RED);
+      parent = _nil;
+    }
+    z->set_parent(parent);
+    if (parent == _nil) {
       _root = z;
-    else if (_comp(_key(z), _key(y)))
-      y->left = z;
-    else
-      y->right = z;
-    z->left = _nil;
-    z->right = _nil;
-    z->color = RED;
+      _nil->left = z;
+      _nil->right = z;
+    } else if (left) {
+      parent->left = z;
+      if (parent == _nil->left)
+        _nil->left = z;
+    } else {
+      parent->right = z;
+      if (parent == _nil->right)
+        _nil->right = z;
+    }
+    _update_path(z);
     _insert_fixup(z);
     ++_size;
-    _nil->aux = _maximum(_root);
-    return ft::make_pair(iterator(z, _nil), true);
-  }
-
-  void _insert_fixup(node_ptr z) {
-    while (z->parent->color == RED) {
-      if (z->parent == z->parent->parent->left) {
-        node_ptr y = z->parent->parent->right;
-        if (y->color == RED) {
-          z->parent->color = BLACK;
-          y->color = BLACK;
-          z->parent->parent->color = RED;
-          z = z->parent->parent;
+    return iterator(z, _nil);
+  }
+
+  /* @brief Restores the red-black properties after the red node z was
+   * linked in.
+   *
+   * @return Whether the black height of the tree grew, which happens when
+   * the red violation climbs up to the root.
+   */
+  bool _insert_fixup(node_ptr z) {
+    while (z->get_parent()->get_color() == RED) {
+      if (z->get_parent() == z->get_parent()->get_parent()->left) {
+        node_ptr y = z->get_parent()->get_parent()->right;
+        if (y->get_color() == RED) {
+          z->get_parent()->set_color(BLACK);
+          y->set_color(BLACK);
+          z->get_parent()->get_parent()->set_color(RED);
+          z = z->get_parent()->get_parent();
         } else {
-          if (z == z->parent->right) {
-            z = z->parent;
+          if (z == z->get_parent()->right) {
+            z = z->get_parent();
             _left_rotate(z);
           }
-          z->parent->color = BLACK;
-          z->parent->parent->color = RED;
-          _right_rotate(z->parent->parent);
+          z->get_parent()->set_color(BLACK);
+          z->get_parent()->get_parent()->set_color(RED);
+          _right_rotate(z->get_parent()->get_parent());
         }
       } else {
-        node_ptr y = z->parent->parent->left;
-        if (y->color == RED) {
-          z->parent->color = BLACK;
-          y->color = BLACK;
-          z->parent->parent->color = RED;
-          z = z->parent->parent;
+        node_ptr y = z->get_parent()->get_parent()->left;
+        if (y->get_color() == RED) {
+          z->get_parent()->set_color(BLACK);
+          y->set_color(BLACK);
+          z->get_parent()->get_parent()->set_color(RED);
+          z = z->get_parent()->get_parent();
         } else {
-          if (z == z->parent->left) {
-            z = z->parent;
+          if (z == z->get_parent()->left) {
+            z = z->get_parent();
             _right_rotate(z);
           }
-          z->parent->color = BLACK;
-          z->parent->parent->color = RED;
-          _left_rotate(z->parent->parent);
+          z->get_parent()->set_color(BLACK);
+          z->get_parent()->get_parent()->set_color(RED);
+          _left_rotate(z->get_parent()->get_parent());
         }
       }
     }
-    _root->color = BLACK;
+    if (_root->get_color() == BLACK)
+      return false;
+    _root->set_color(BLACK);
+    return true;
   }
 
-  /*
-   * @brief: Destroy tree
+  /* @brief Destroys the subtree rooted at node, without recursion.
    *
-   * @param:
-   *  node: root of the tree to destroy
+   * Nodes are destroyed in preorder from an explicit stack, which holds at
+   * most one pending right child per level. Each node is read once, and its
+   * children are prefetched as they are pushed, so that scattered nodes are
+   * fetched while earlier ones are destroyed.
    *
-   *  Destroy nodes and deallocate all tree memory
+   * @return The number of nodes destroyed.
    */
-  void _destroy_tree(node_ptr node) {
-    if (node != _nil) {
-      _destroy_tree(node->left);
-      _destroy_tree(node->right);
-      _destroy_node(node);
+  size_type _destroy_tree(node_ptr node) {
+    if (node == _nil)
+      return 0;
+    node_ptr stack[_max_height + 1];
+    size_type top = 0;
+    size_type count = 0;
+    stack[top++] = node;
+    while (top > 0) {
+      _destroy_node(_preorder_step(stack, top));
+      ++count;
     }
+    return count;
   }
 
   void _destroy_node(node_ptr node) {
-    _node_alloc.destroy(node);
+    _alloc.destroy(&node->data);
     _node_alloc.deallocate(node, 1);
   }
 
@@ -744,27 +1786,330 @@ private:
    * properties.
    */
 
-  void _erase_aux(iterator position) {
-    node_ptr y = _remove(position._node);
-    _destroy_node(y);
+  void _erase_aux(iterator position) { _destroy_node(_unlink(position._node)); }
+
+  /* @brief Removes the node z from the tree without destroying it.
+   * @return z, detached.
+   */
+  node_ptr _unlink(node_ptr z) {
+    // The minimum has no left child, so its successor is either the minimum
+    // of its right subtree or its parent; the maximum mirrors it
+    if (z == _nil->left)
+      _nil->left = z->right != _nil ? _minimum(z->right) : z->get_parent();
+    if (z == _nil->right)
+      _nil->right = z->left != _nil ? _maximum(z->left) : z->get_parent();
     --_size;
-    _nil->aux = _maximum(_root);
+    return _remove(z);
   }
 
+  /* @brief Removes the nodes in [first, last).
+   *
+   * Short ranges are removed node by node. Longer ones are cut out of the tree
+   * by splitting it before first and after last - 1, then joining what
+   * remains around the node at last. The splits and the join cost O(log n)
+   * in total, so only the destruction of the erased nodes is linear.
+   */
   void _erase_aux(iterator first, iterator last) {
-    if (first == begin() && last == end())
+    if (first == last)
+      return;
+    if (first == begin() && last == end()) {
       clear();
-    else {
-      while (first != last) {
-        erase(first++);
+      return;
+    }
+    iterator next = first;
+    for (size_type n = 0; next != last && n < _min_split_erase; n++)
+      ++next;
+    if (next == last) {
+      while (first != last)
+        _erase_aux(first++);
+      return;
+    }
+    node_ptr min = first._node == _nil->left ? last._node : _nil->left;
+    node_ptr max = _nil->right;
+    if (last._node == _nil)
+      max = (--iterator(first))._node;
+    node_ptr left, right = _nil, middle;
+    size_type left_height, right_height = 0, middle_height;
+    if (last._node != _nil)
+      _split(last._node, left, left_height, right, right_height);
+    _split(first._node, left, left_height, middle, middle_height);
+    _size -= _destroy_tree(middle) + 1;
+    _destroy_node(first._node);
+    if (last._node != _nil)
+      left = _join(left, left_height, last._node, right, right_height,
+                   left_height);
+    _root = left;
+    _nil->left = min;
+    _nil->right = max;
+  }
+
+  /* @brief Counts the nodes of the smaller of the trees rooted at a and b,
+   * in time linear in its size, by walking both trees side by side.
+   *
+   * @param a_smaller Set to whether the tree rooted at a is the smaller one.
+   * @return The size of the smaller tree.
+   */
+  size_type _smaller_size(node_ptr a, node_ptr b, bool &a_smaller) const {
+    node_ptr stack_a[_max_height + 1];
+    node_ptr stack_b[_max_height + 1];
+    size_type top_a = 0;
+    size_type top_b = 0;
+    if (a != _nil)
+      stack_a[top_a++] = a;
+    if (b != _nil)
+      stack_b[top_b++] = b;
+    for (size_type count = 0;; count++) {
+      if (top_a == 0 || top_b == 0) {
+        a_smaller = top_a == 0;
+        return count;
+      }
+      _preorder_step(stack_a, top_a);
+      _preorder_step(stack_b, top_b);
+    }
+  }
+
+  /* @brief Pops the next node of a preorder walk off the stack and pushes
+   * its children, prefetching them.
+   * @return The popped node.
+   */
+  node_ptr _preorder_step(node_ptr *stack, size_type &top) const {
+    node_ptr node = stack[--top];
+    if (node->right != _nil)
+      FT_PREFETCH(stack[top++] = node->right);
+    if (node->left != _nil)
+      FT_PREFETCH(stack[top++] = node->left);
+    return node;
+  }
+
+  /* @brief Points the leaves of the tree rooted at root, and the parent link
+   * of root, at the sentinel to instead of from.
+   */
+  void _relink(node_ptr root, node_ptr from, node_ptr to) {
+    node_ptr stack[_max_height + 1];
+    size_type top = 0;
+    root->set_parent(to);
+    stack[top++] = root;
+    while (top > 0) {
+      node_ptr node = stack[--top];
+      if (node->right == from)
+        node->right = to;
+      else
+        FT_PREFETCH(stack[top++] = node->right);
+      if (node->left == from)
+        node->left = to;
+      else
+        FT_PREFETCH(stack[top++] = node->left);
+    }
+  }
+
+  /* @brief Joins other, whose keys all go after those of this nonempty tree,
+   * onto it, around the minimum of other. other is left empty.
+   */
+  void _append(RedBlackTree &other) {
+    node_ptr min = _nil->left;
+    node_ptr max = other._nil->right;
+    node_ptr pivot = other._nil->left;
+    node_ptr left = _root;
+    if (other._size > _size) {
+      _relink(_root, _nil, other._nil);
+      ft::swap(_nil, other._nil);
+    } else {
+      _relink(other._root, other._nil, _nil);
+    }
+    size_type left_height = _black_height(left);
+    node_ptr rest, right;
+    size_type rest_height, right_height;
+    _split(pivot, rest, rest_height, right, right_height);
+    _root = _join(left, left_height, pivot, right, right_height, left_height);
+    _size += other._size;
+    _nil->left = min;
+    _nil->right = max;
+    other._root = other._nil;
+    other._size = 0;
+    other._nil->init(other._nil, BLACK);
+    other._node_alloc.release();
+  }
+
+  /* @brief Moves the nodes of other into this tree, one at a time: all of
+   * them if equal keys are allowed, else those whose keys are missing here.
+   */
+  void _merge(RedBlackTree &other, bool equal) {
+    node_ptr x = other._nil->left;
+    while (x != other._nil) {
+      node_ptr next = (++iterator(x, other._nil))._node;
+      node_ptr parent;
+      bool left;
+      bool free = true;
+      if (equal)
+        _insert_equal_pos(_key(x), parent, left);
+      else
+        free = _insert_pos(_key(x), parent, left) == _nil;
+      if (free) {
+        other._unlink(x);
+        x->init(_nil, RED);
+        _link_node(parent, left, x);
+      }
+      x = next;
+    }
+  }
+
+  /* @brief Recomputes the augmented summaries of x and of its ancestors,
+   * after the subtree rooted at x changed. A no-op without augmentation.
+   */
+  void _update_path(node_ptr x) {
+    if (!augment_type::enabled)
+      return;
+    for (; x != _nil; x = x->get_parent())
+      augment_type::update(x, _nil);
+  }
+
+  /* @brief Returns the black height of the subtree rooted at node, counting
+   * node itself but not the sentinel.
+   */
+  size_type _black_height(node_ptr node) const {
+    size_type height = 0;
+    for (; node != _nil; node = node->left)
+      if (node->get_color() == BLACK)
+        ++height;
+    return height;
+  }
+
+  /* @brief Detaches the subtree rooted at node as a tree of its own, whose
+   * root is black.
+   *
+   * @param height The black height of the subtree.
+   * @return The black height of the detached tree, one more than height if
+   * its root had to be blackened.
+   */
+  size_type _detach(node_ptr node, size_type height) {
+    if (node == _nil)
+      return 0;
+    node->set_parent(_nil);
+    if (node->get_color() == BLACK)
+      return height;
+    node->set_color(BLACK);
+    return height + 1;
+  }
+
+  /* @brief Joins two detached trees around the detached node k, whose key
+   * lies between theirs.
+   *
+   * @param left, right Trees with a black root and a parent link to the
+   * sentinel, or the sentinel itself.
+   * @param left_height, right_height Their black heights.
+   * @param height Set to the black height of the joined tree.
+   * @return The root of the joined tree, with the same properties.
+   *
+   * If the heights differ, k is linked in red along the inner spine of the
+   * taller tree, in place of the first black node as high as the other
+   * tree, and the taller tree is rebalanced as for an insertion. That costs
+   * O(1 + |left_height - right_height|). Rebalancing goes through _root,
+   * which is pointed at the taller tree for the duration.
+   */
+  node_ptr _join(node_ptr left, size_type left_height, node_ptr k,
+                 node_ptr right, size_type right_height, size_type &height) {
+    if (left_height == right_height) {
+      k->init(_nil, BLACK);
+      k->left = left;
+      k->right = right;
+      if (left != _nil)
+        left->set_parent(k);
+      if (right != _nil)
+        right->set_parent(k);
+      height = left_height + 1;
+      augment_type::update(k, _nil);
+      return k;
+    }
+    node_ptr parent = _nil;
+    node_ptr x;
+    k->init(_nil, RED);
+    if (left_height > right_height) {
+      x = left;
+      for (size_type h = left_height;
+           x->get_color() == RED || h > right_height; x = x->right) {
+        if (x->get_color() == BLACK)
+          --h;
+        parent = x;
+      }
+      parent->right = k;
+      k->left = x;
+      k->right = right;
+      _root = left;
+    } else {
+      x = right;
+      for (size_type h = right_height;
+           x->get_color() == RED || h > left_height; x = x->left) {
+        if (x->get_color() == BLACK)
+          --h;
+        parent = x;
+      }
+      parent->left = k;
+      k->left = left;
+      k->right = x;
+      _root = right;
+    }
+    k->set_parent(parent);
+    if (k->left != _nil)
+      k->left->set_parent(k);
+    if (k->right != _nil)
+      k->right->set_parent(k);
+    _update_path(k);
+    height = left_height > right_height ? left_height : right_height;
+    if (_insert_fixup(k))
+      ++height;
+    return _root;
+  }
+
+  /* @brief Cuts the tree that holds the node x into the nodes before x and
+   * the nodes after it, leaving x detached.
+   *
+   * @param left, right Set to the roots of the two parts, detached as by
+   * _join.
+   * @param left_height, right_height Set to their black heights.
+   *
+   * The parts start as the subtrees of x. Walking up from x, each ancestor
+   * is joined, together with its other subtree, onto the part on its side.
+   * The parts grow in black height as they climb, so the costs of the joins
+   * telescope to O(log n).
+   */
+  void _split(node_ptr x, node_ptr &left, size_type &left_height,
+              node_ptr &right, size_type &right_height) {
+    size_type height = _black_height(x->left);
+    node_ptr child = x;
+    node_ptr parent = x->get_parent();
+    left = x->left;
+    right = x->right;
+    left_height = _detach(left, height);
+    right_height = _detach(right, height);
+    if (x->get_color() == BLACK)
+      ++height;
+    while (parent != _nil) {
+      node_ptr next = parent->get_parent();
+      bool black = parent->get_color() == BLACK;
+      if (child == parent->left) {
+        node_ptr sibling = parent->right;
+        size_type sibling_height = _detach(sibling, height);
+        right = _join(right, right_height, parent, sibling, sibling_height,
+                      right_height);
+      } else {
+        node_ptr sibling = parent->left;
+        size_type sibling_height = _detach(sibling, height);
+        left = _join(sibling, sibling_height, parent, left, left_height,
+                     left_height);
       }
+      if (black)
+        ++height;
+      child = parent;
+      parent = next;
     }
+    x->init(_nil, RED);
   }
 
   node_ptr _remove(node_ptr z) {
     node_ptr x;
     node_ptr y = z;
-    color y_original_color = y->color;
+    node_ptr changed = z->get_parent(); // lowest node that lost a descendant
+    color y_original_color = y->get_color();
     if (z->left == _nil) {
       x = z->right;
       _transplant(z, z->right);
@@ -773,20 +2118,23 @@ private:
       _transplant(z, z->left);
     } else {
       y = _minimum(z->right);
-      y_original_color = y->color;
+      y_original_color = y->get_color();
       x = y->right;
-      if (y->parent == z)
-        x->parent = y;
-      else {
+      if (y->get_parent() == z) {
+        x->set_parent(y);
+        changed = y;
+      } else {
+        changed = y->get_parent();
         _transplant(y, y->right);
         y->right = z->right;
-        y->right->parent = y;
+        y->right->set_parent(y);
       }
       _transplant(z, y);
       y->left = z->left;
-      y->left->parent = y;
-      y->color = z->color;
+      y->left->set_parent(y);
+      y->set_color(z->get_color());
     }
+    _update_path(changed);
     if (y_original_color == BLACK) {
       _remove_fixup(x);
     }
@@ -795,164 +2143,58 @@ private:
 
   void _remove_fixup(node_ptr x) {
     node_ptr w;
-    while (x != _root && x->color == BLACK) {
-      if (x == x->parent->left) {
-        w = x->parent->right;
-        if (w->color == RED) {
-          w->color = BLACK;
-          x->parent->color = RED;
-          _left_rotate(x->parent);
-          w = x->parent->right;
+    while (x != _root && x->get_color() == BLACK) {
+      if (x == x->get_parent()->left) {
+        w = x->get_parent()->right;
+        if (w->get_color() == RED) {
+          w->set_color(BLACK);
+          x->get_parent()->set_color(RED);
+          _left_rotate(x->get_parent());
+          w = x->get_parent()->right;
         }
-        if (w->left->color == BLACK && w->right->color == BLACK) {
-          w->color = RED;
-          x = x->parent;
-        } else if (w->right->color == BLACK) {
-          w->left->color = BLACK;
-          w->color = RED;
-          _right_rotate(w);
-          w = x->parent->right;
+        if (w->left->get_color() == BLACK && w->right->get_color() == BLACK) {
+          w->set_color(RED);
+          x = x->get_parent();
+        } else {
+          if (w->right->get_color() == BLACK) {
+            w->left->set_color(BLACK);
+            w->set_color(RED);
+            _right_rotate(w);
+            w = x->get_parent()->right;
+          }
+          w->set_color(x->get_parent()->get_color());
+          x->get_parent()->set_color(BLACK);
+          w->right->set_color(BLACK);
+          _left_rotate(x->get_parent());
+          x = _root;
         }
-        w->color = x->parent->color;
-        x->parent->color = BLACK;
-        w->right->color = BLACK;
-        _left_rotate(x->parent);
-        x = _root;
       } else {
-        w = x->parent->left;
-        if (w->color == RED) {
-          w->color = BLACK;
-          x->parent->color = RED;
-          _right_rotate(x->parent);
-          w = x->parent->left;
-        }
-        if (w->right->color == BLACK && w->left->color == BLACK) {
-          w->color = RED;
-          x = x->parent;
-        } else if (w->left->color == BLACK) {
-          w->right->color = BLACK;
-          w->color = RED;
-          _left_rotate(w);
-          w = x->parent->left;
+        w = x->get_parent()->left;
+        if (w->get_color() == RED) {
+          w->set_color(BLACK);
+          x->get_parent()->set_color(RED);
+          _right_rotate(x->get_parent());
+          w = x->get_parent()->left;
         }
-        w->color = x->parent->color;
-        x->parent->color = BLACK;
-        w->left->color = BLACK;
-        _right_rotate(x->parent);
-        x = _root;
-      }
-    }
-    x->color = BLACK;
-  }
-
-  node_ptr _tree_rebalance_for_erase(node_ptr const z) {
-    node_ptr y = z;
-    node_ptr x = 0;
-    node_ptr x_parent = 0;
-
-    if (y->left == _nil)
-      x = y->right;
-    else if (y->right == _nil)
-      x = y->left;
-    else {
-      y = y->right;
-      while (y->left != _nil)
-        y = y->left;
-      x = y->right;
-    }
-    if (y != z) {
-      z->left->parent = y;
-      y->left = z->left;
-      if (y != z->right) {
-        x_parent = y->parent;
-        if (x)
-          x->parent = y->parent;
-        y->parent->left = x;
-        y->right = z->right;
-        z->right->parent = y;
-      } else
-        x_parent = y;
-      if (_root == z)
-        _root = y;
-      else if (z->parent->left == z)
-        z->parent->left = y;
-      else
-        z->parent->right = y;
-      y->parent = z->parent;
-      std::swap(y->color, z->color);
-      y = z;
-    } else {
-      x_parent = y->parent;
-      if (x)
-        x->parent = y->parent;
-      if (_root == z)
-        _root = x;
-      else if (z->parent->left == z)
-        z->parent->left = x;
-      else
-        z->parent->right = x;
-    }
-    if (y->color != RED) {
-      while (x != _root && (x == _nil || x->color == BLACK))
-        if (x == x_parent->left) {
-          node_ptr w = x_parent->right;
-          if (w->color == RED) {
-            w->color = BLACK;
-            x_parent->color = RED;
-            _left_rotate(x_parent);
-            w = x_parent->right;
-          }
-          if ((w->left == _nil || w->left->color == BLACK) &&
-              (w->right == _nil || w->right->color == BLACK)) {
-            w->color = RED;
-            x = x_parent;
-            x_parent = x_parent->parent;
-          } else {
-            if (w->right == _nil || w->right->color == BLACK) {
-              w->left->color = BLACK;
-              w->color = RED;
-              _right_rotate(w);
-              w = x_parent->right;
-            }
-            w->color = x_parent->color;
-            x_parent->color = BLACK;
-            if (w->right != _nil)
-              w->right->color = BLACK;
-            _left_rotate(x_parent);
-            break;
-          }
+        if (w->right->get_color() == BLACK && w->left->get_color() == BLACK) {
+          w->set_color(RED);
+          x = x->get_parent();
         } else {
-          node_ptr w = x_parent->left;
-          if (w->color == RED) {
-            w->color = BLACK;
-            x_parent->color = RED;
-            _right_rotate(x_parent);
-            w = x_parent->left;
-          }
-          if ((w->right == _nil || w->right->color == BLACK) &&
-              (w->left == _nil || w->left->color == BLACK)) {
-            w->color = RED;
-            x = x_parent;
-            x_parent = x_parent->parent;
-          } else {
-            if (w->left == _nil || w->left->color == BLACK) {
-              w->right->color = BLACK;
-              w->color = RED;
-              _left_rotate(w);
-              w = x_parent->left;
-            }
-            w->color = x_parent->color;
-            x_parent->color = BLACK;
-            if (w->left != _nil)
-              w->left->color = BLACK;
-            _right_rotate(x_parent);
-            break;
+          if (w->left->get_color() == BLACK) {
+            w->right->set_color(BLACK);
+            w->set_color(RED);
+            _left_rotate(w);
+            w = x->get_parent()->left;
           }
+          w->set_color(x->get_parent()->get_color());
+          x->get_parent()->set_color(BLACK);
+          w->left->set_color(BLACK);
+          _right_rotate(x->get_parent());
+          x = _root;
         }
-      if (x == _nil)
-        x->color = BLACK;
+      }
     }
-    return y;
+    x->set_color(BLACK);
   }
 
   /* @brief Transplant node z with node y
@@ -964,14 +2206,14 @@ private:
    */
 
   void _transplant(node_ptr u, node_ptr v) {
-    if (u->parent == _nil) {
+    if (u->get_parent() == _nil) {
       _root = v;
-    } else if (u == u->parent->left) {
-      u->parent->left = v;
+    } else if (u == u->get_parent()->left) {
+      u->get_parent()->left = v;
     } else {
-      u->parent->right = v;
+      u->get_parent()->right = v;
     }
-    v->parent = u->parent;
+    v->set_parent(u->get_parent());
   }
 
   /* @brief Left Rotate
@@ -996,16 +2238,18 @@ private:
     node_ptr y = x->right;
     x->right = y->left;
     if (y->left != _nil)
-      y->left->parent = x;
-    y->parent = x->parent;
-    if (x->parent == _nil)
+      y->left->set_parent(x);
+    y->set_parent(x->get_parent());
+    if (x->get_parent() == _nil)
       _root = y;
-    else if (x == x->parent->left)
-      x->parent->left = y;
+    else if (x == x->get_parent()->left)
+      x->get_parent()->left = y;
     else
-      x->parent->right = y;
+      x->get_parent()->right = y;
     y->left = x;
-    x->parent = y;
+    x->set_parent(y);
+    augment_type::update(x, _nil);
+    augment_type::update(y, _nil);
   }
 
   /* @brief Right Rotate
@@ -1024,16 +2268,18 @@ private:
     node_ptr y = x->left;
     x->left = y->right;
     if (y->right != _nil)
-      y->right->parent = x;
-    y->parent = x->parent;
-    if (x->parent == _nil)
+      y->right->set_parent(x);
+    y->set_parent(x->get_parent());
+    if (x->get_parent() == _nil)
       _root = y;
-    else if (x == x->parent->right)
-      x->parent->right = y;
+    else if (x == x->get_parent()->right)
+      x->get_parent()->right = y;
     else
-      x->parent->left = y;
+      x->get_parent()->left = y;
     y->right = x;
-    x->parent = y;
+    x->set_parent(y);
+    augment_type::update(x, _nil);
+    augment_type::update(y, _nil);
   }
 };
 
@@ -6,6 +6,11 @@ namespace ft {
 template <bool Cond, class T = void> struct enable_if {};
 template <class T> struct enable_if<true, T> { typedef T type; };
 
+template <bool Cond, class T, class F> struct conditional { typedef T type; };
+template <class T, class F> struct conditional<false, T, F> {
+  typedef F type;
+};
+
 template <class T, T v> struct integral_constant {
   static const T value = v;
   typedef T value_type;
@@ -16,6 +21,9 @@ template <class T, T v> struct integral_constant {
 typedef integral_constant<bool, true> true_type;
 typedef integral_constant<bool, false> false_type;
 
+template <class T> struct is_void : false_type {};
+template <> struct is_void<void> : true_type {};
+
 template <class T> struct is_integral : false_type {};
 template <class T> struct is_integral<const T> : is_integral<T> {};
 template <class T> struct is_integral<volatile T> : is_integral<T> {};
@@ -37,6 +45,102 @@ template <> struct is_integral<unsigned int> : true_type {};
 template <> struct is_integral<unsigned long int> : true_type {};
 template <> struct is_integral<unsigned long long int> : true_type {};
 
+template <class T> struct is_floating_point : false_type {};
+template <class T> struct is_floating_point<const T> : is_floating_point<T> {};
+template <class T>
+struct is_floating_point<volatile T> : is_floating_point<T> {};
+template <class T>
+struct is_floating_point<const volatile T> : is_floating_point<T> {};
+
+template <> struct is_floating_point<float> : true_type {};
+template <> struct is_floating_point<double> : true_type {};
+template <> struct is_floating_point<long double> : true_type {};
+
+/**
+ * @brief Whether objects of type T can be copied and relocated with
+ * std::memcpy or std::memmove, without running constructors or destructors.
+ *
+ * GCC and Clang answer through their builtin, which is available in every
+ * language mode. Elsewhere only arithmetic and pointer types qualify, and
+ * other plain structs can opt in by specializing this trait.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+template <class T>
+struct is_trivially_copyable
+    : integral_constant<bool, __is_trivially_copyable(T)> {};
+#else
+template <class T>
+struct is_trivially_copyable
+    : integral_constant<bool, is_integral<T>::value ||
+                                  is_floating_point<T>::value> {};
+template <class T> struct is_trivially_copyable<T *> : true_type {};
+#endif
+
+/**
+ * @brief Whether destroying an object of type T runs no code, so that
+ * containers may release its storage without visiting it.
+ *
+ * Answered by the compiler builtin where available, and otherwise for
+ * arithmetic and pointer types only, like is_trivially_copyable.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+template <class T>
+struct is_trivially_destructible
+    : integral_constant<bool, __has_trivial_destructor(T)> {};
+#else
+template <class T>
+struct is_trivially_destructible
+    : integral_constant<bool, is_integral<T>::value ||
+                                  is_floating_point<T>::value> {};
+template <class T> struct is_trivially_destructible<T *> : true_type {};
+#endif
+
+/**
+ * @brief Whether T is a class with no data, so that every object of it,
+ * including a default-constructed one, behaves the same.
+ *
+ * Answered by the compiler builtin where available. Elsewhere T must be a
+ * class type that can be derived from.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+template <class T> struct is_empty : integral_constant<bool, __is_empty(T)> {};
+#else
+template <class T> struct _empty_probe : T {
+  char c;
+};
+
+template <class T>
+struct is_empty : integral_constant<bool, sizeof(_empty_probe<T>) == 1> {};
+#endif
+
+/**
+ * @brief Whether containers exchange allocators when they are swapped.
+ *
+ * Reads Alloc::propagate_on_container_swap when the allocator declares it
+ * and defaults to false_type otherwise, as std::allocator_traits does.
+ * Without propagation, swapping containers whose allocators compare unequal
+ * is undefined behavior.
+ */
+template <class Alloc> struct _has_propagate_on_container_swap {
+private:
+  typedef char _yes;
+  typedef char _no[2];
+
+  template <class U>
+  static _yes &_test(typename U::propagate_on_container_swap *);
+  template <class U> static _no &_test(...);
+
+public:
+  static const bool value = sizeof(_test<Alloc>(0)) == sizeof(_yes);
+};
+
+template <class Alloc, bool = _has_propagate_on_container_swap<Alloc>::value>
+struct propagate_on_container_swap : false_type {};
+
+template <class Alloc>
+struct propagate_on_container_swap<Alloc, true>
+    : integral_constant<bool, Alloc::propagate_on_container_swap::value> {};
+
 } // namespace ft
 
 #endif // TYPE_TRAITS_HPP
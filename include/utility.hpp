@@ -1,8 +1,19 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+#include "config.hpp"
+#include <new>
+
 namespace ft {
 
+/**
+ * @brief Tag selecting the pair constructor that builds second in place from
+ * a set of emplace arguments.
+ */
+struct piecewise_construct_t {};
+
+const piecewise_construct_t piecewise_construct = piecewise_construct_t();
+
 template <class T1, class T2> struct pair {
 public:
   typedef T1 first_type;
@@ -18,6 +29,14 @@ public:
 
   pair(const first_type &a, const second_type &b) : first(a), second(b) {}
 
+  /**
+   * @brief Copies a into first and constructs second from args, an
+   * ft::make_emplace_args result, without a temporary second_type.
+   */
+  template <class Args>
+  pair(piecewise_construct_t, const first_type &a, const Args &args)
+      : first(a), second(args.template make<second_type>()) {}
+
   pair &operator=(const pair &pr) {
     if (this != &pr) {
       first = pr.first;
@@ -25,6 +44,18 @@ public:
     }
     return *this;
   }
+
+#if FT_HAS_MOVE
+  pair(const pair &) = default;
+
+  pair(pair &&) = default;
+
+  pair &operator=(pair &&pr) {
+    first = std::move(pr.first);
+    second = std::move(pr.second);
+    return *this;
+  }
+#endif
 };
 
 template <class T1, class T2>
@@ -62,6 +93,122 @@ template <class T1, class T2> pair<T1, T2> make_pair(T1 x, T2 y) {
   return (pair<T1, T2>(x, y));
 }
 
+/**
+ * @brief Constructor arguments captured by reference, so that emplace
+ * functions can construct a value directly in container storage.
+ *
+ * C++98 has no variadic templates, so each arity gets its own class and the
+ * arguments are forwarded as const references. construct() builds a T in
+ * raw storage; make() returns one by value, which compilers construct in
+ * place at the call site.
+ */
+struct emplace_args0 {
+  template <class T> void construct(T *p) const {
+    ::new (static_cast<void *>(p)) T();
+  }
+
+  template <class T> T make() const { return T(); }
+};
+
+template <class A1> struct emplace_args1 {
+  const A1 &a1;
+
+  explicit emplace_args1(const A1 &a1) : a1(a1) {}
+
+  template <class T> void construct(T *p) const {
+    ::new (static_cast<void *>(p)) T(a1);
+  }
+
+  template <class T> T make() const {
+    T value(a1);
+    return value;
+  }
+};
+
+template <class A1, class A2> struct emplace_args2 {
+  const A1 &a1;
+  const A2 &a2;
+
+  emplace_args2(const A1 &a1, const A2 &a2) : a1(a1), a2(a2) {}
+
+  template <class T> void construct(T *p) const {
+    ::new (static_cast<void *>(p)) T(a1, a2);
+  }
+
+  template <class T> T make() const {
+    T value(a1, a2);
+    return value;
+  }
+};
+
+template <class A1, class A2, class A3> struct emplace_args3 {
+  const A1 &a1;
+  const A2 &a2;
+  const A3 &a3;
+
+  emplace_args3(const A1 &a1, const A2 &a2, const A3 &a3)
+      : a1(a1), a2(a2), a3(a3) {}
+
+  template <class T> void construct(T *p) const {
+    ::new (static_cast<void *>(p)) T(a1, a2, a3);
+  }
+
+  template <class T> T make() const {
+    T value(a1, a2, a3);
+    return value;
+  }
+};
+
+inline emplace_args0 make_emplace_args() { return emplace_args0(); }
+
+template <class A1> emplace_args1<A1> make_emplace_args(const A1 &a1) {
+  return emplace_args1<A1>(a1);
+}
+
+template <class A1, class A2>
+emplace_args2<A1, A2> make_emplace_args(const A1 &a1, const A2 &a2) {
+  return emplace_args2<A1, A2>(a1, a2);
+}
+
+template <class A1, class A2, class A3>
+emplace_args3<A1, A2, A3> make_emplace_args(const A1 &a1, const A2 &a2,
+                                            const A3 &a3) {
+  return emplace_args3<A1, A2, A3>(a1, a2, a3);
+}
+
+#if FT_HAS_MOVE
+/**
+ * @brief Like emplace_args1, for an argument that is moved from.
+ */
+template <class A1> struct emplace_move_args1 {
+  A1 &a1;
+
+  explicit emplace_move_args1(A1 &a1) : a1(a1) {}
+
+  template <class T> void construct(T *p) const {
+    ::new (static_cast<void *>(p)) T(std::move(a1));
+  }
+
+  template <class T> T make() const {
+    T value(std::move(a1));
+    return value;
+  }
+};
+
+template <class A1> emplace_move_args1<A1> make_emplace_move_args(A1 &a1) {
+  return emplace_move_args1<A1>(a1);
+}
+#endif
+
+/**
+ * @brief Tag selecting the overloads that take a range already sorted by the
+ * container's comparator and free of equivalent keys. Passing any other
+ * range to them is undefined behavior.
+ */
+struct sorted_unique_t {};
+
+const sorted_unique_t sorted_unique = sorted_unique_t();
+
 } // namespace ft
 
 #endif
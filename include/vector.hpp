@@ -2,21 +2,67 @@
 #define VECTOR_HPP
 
 #include "algorithm.hpp"
+#include "config.hpp"
 #include "iterator.hpp"
 #include "random_access_iterator.hpp"
+#include "small_buffer_allocator.hpp"
 #include "type_traits.hpp"
+#include "utility.hpp"
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 
 namespace ft {
 
+/**
+ * @brief Growth policy that scales the capacity by Num / Den whenever the
+ * elements no longer fit, or grows to the required size if that is larger.
+ * The capacity never shrinks on its own.
+ *
+ * A smaller factor such as vector_growth_policy<3, 2> wastes less memory at
+ * the cost of more reallocations.
+ */
+template <std::size_t Num, std::size_t Den = 1> struct vector_growth_policy {
+  static std::size_t next_capacity(std::size_t capacity,
+                                   std::size_t required) {
+    std::size_t grown = capacity / Den * Num + capacity % Den * Num / Den;
+    return grown < required ? required : grown;
+  }
+
+  static std::size_t shrunk_capacity(std::size_t capacity, std::size_t) {
+    return capacity;
+  }
+};
+
+typedef vector_growth_policy<2> vector_default_policy;
+
+/**
+ * @brief Policy that grows like Growth and halves the capacity whenever an
+ * erasure leaves fewer than Num / Den of it in use.
+ *
+ * The gap between the shrink threshold and the next growth keeps a vector
+ * that oscillates around a boundary from reallocating on every call.
+ */
+template <class Growth = vector_default_policy, std::size_t Num = 1,
+          std::size_t Den = 4>
+struct vector_hysteresis_policy : Growth {
+  static std::size_t shrunk_capacity(std::size_t capacity, std::size_t size) {
+    if (size >= capacity / Den * Num + capacity % Den * Num / Den)
+      return capacity;
+    return size < capacity / 2 ? capacity / 2 : size;
+  }
+};
+
 /**
  * @brief A vector class.
  * @tparam T The type of the elements.
  * @tparam Allocator The allocator type.
+ * @tparam Policy The growth policy, such as ft::vector_growth_policy.
  */
-template <class T, class Alloc = std::allocator<T>> class vector {
+template <class T, class Alloc = std::allocator<T>,
+          class Policy = ft::vector_default_policy>
+class vector {
 public:
   typedef T value_type;
   typedef Alloc allocator_type;
@@ -38,7 +84,9 @@ private:
   size_type _capacity;   // capacity of the vector
   allocator_type _alloc; // allocator object
   static const size_type _init_capacity = 0; // Initial capacity
-  static const size_type _growth_factor = 2; // Growth factor
+
+  // Selects the bulk memory paths for element types that allow them
+  typedef typename ft::is_trivially_copyable<value_type>::type _is_trivial;
 
   /**
    * @brief Check if the vector has enough capacity to store n elements.
@@ -53,6 +101,288 @@ private:
     }
   }
 
+  /**
+   * @brief Exchanges allocators with x if the allocator propagates on swap.
+   */
+  void _swap_allocator(vector &x, ft::true_type) { ft::swap(_alloc, x._alloc); }
+
+  void _swap_allocator(vector &, ft::false_type) {}
+
+  /**
+   * @brief Allocates storage for n elements. The allocator counts elements,
+   * not bytes. Empty requests return NULL without allocating.
+   */
+  pointer _allocate(size_type n) { return n ? _alloc.allocate(n) : NULL; }
+
+  /**
+   * @brief Returns storage for n elements obtained from _allocate(n).
+   */
+  void _deallocate(pointer p, size_type n) {
+    if (p != NULL)
+      _alloc.deallocate(p, n);
+  }
+
+  /**
+   * @brief Copy-constructs n elements from src into uninitialized storage at
+   * dest. If a copy throws, the elements constructed so far are destroyed.
+   */
+  void _uninitialized_copy(pointer dest, const_pointer src, size_type n,
+                           ft::false_type) {
+    size_type i = 0;
+    try {
+      for (; i < n; i++)
+        _alloc.construct(dest + i, src[i]);
+    } catch (...) {
+      _destroy(dest, i);
+      throw;
+    }
+  }
+
+  // memcpy and memmove take no null pointers, even for a zero size, and the
+  // storage of an empty vector is null
+  void _uninitialized_copy(pointer dest, const_pointer src, size_type n,
+                           ft::true_type) {
+    if (n > 0 && dest != NULL && src != NULL)
+      std::memcpy(static_cast<void *>(dest), src, n * sizeof(value_type));
+  }
+
+  /**
+   * @brief Constructs *dest from *src, which is about to be destroyed. With
+   * move support the element is moved, unless its move constructor may throw
+   * and a copy keeps the strong guarantee.
+   */
+  void _construct_relocated(pointer dest, pointer src) {
+#if FT_HAS_MOVE
+    ::new (static_cast<void *>(dest)) value_type(std::move_if_noexcept(*src));
+#else
+    _alloc.construct(dest, *src);
+#endif
+  }
+
+  /**
+   * @brief Like _uninitialized_copy, for elements about to be destroyed, so
+   * that they are moved whenever _construct_relocated allows it.
+   */
+  void _uninitialized_relocate(pointer dest, pointer src, size_type n,
+                               ft::false_type) {
+    size_type i = 0;
+    try {
+      for (; i < n; i++)
+        _construct_relocated(dest + i, src + i);
+    } catch (...) {
+      _destroy(dest, i);
+      throw;
+    }
+  }
+
+  void _uninitialized_relocate(pointer dest, pointer src, size_type n,
+                               ft::true_type) {
+    _uninitialized_copy(dest, src, n, ft::true_type());
+  }
+
+  /**
+   * @brief Destroys n elements starting at first.
+   */
+  void _destroy(pointer first, size_type n) {
+    _destroy(first, n, _is_trivial());
+  }
+
+  void _destroy(pointer first, size_type n, ft::false_type) {
+    for (size_type i = 0; i < n; i++)
+      _alloc.destroy(first + i);
+  }
+
+  void _destroy(pointer, size_type, ft::true_type) {}
+
+  /**
+   * @brief Moves n elements from src to dest within the same storage, leaving
+   * the slots only src covered uninitialized. The ranges may overlap.
+   */
+  void _relocate(pointer dest, pointer src, size_type n, ft::false_type) {
+    if (dest < src) {
+      for (size_type i = 0; i < n; i++) {
+        _construct_relocated(dest + i, src + i);
+        _alloc.destroy(src + i);
+      }
+    } else if (dest > src) {
+      for (size_type i = n; i > 0; i--) {
+        _construct_relocated(dest + i - 1, src + i - 1);
+        _alloc.destroy(src + i - 1);
+      }
+    }
+  }
+
+  void _relocate(pointer dest, pointer src, size_type n, ft::true_type) {
+    if (n > 0 && dest != NULL && src != NULL)
+      std::memmove(static_cast<void *>(dest), src, n * sizeof(value_type));
+  }
+
+  /**
+   * @brief Makes an empty vector's storage hold at least n elements, without
+   * relocating anything.
+   */
+  void _reallocate_empty(size_type n) {
+    if (n <= _capacity)
+      return;
+    _deallocate(_data, _capacity);
+    _data = NULL;
+    _capacity = 0;
+    _data = _allocate(n);
+    _capacity = n;
+  }
+
+protected:
+  /**
+   * @brief Moves the elements to new storage for exactly n elements, with n
+   * no smaller than size().
+   */
+  void _reallocate(size_type n) {
+    pointer tmp = _allocate(n);
+    try {
+      _uninitialized_relocate(tmp, _data, _size, _is_trivial());
+    } catch (...) {
+      _deallocate(tmp, n);
+      throw;
+    }
+    _destroy(_data, _size);
+    _deallocate(_data, _capacity);
+    _capacity = n;
+    _data = tmp;
+  }
+
+private:
+  /**
+   * @brief Gives the policy a chance to trim the capacity after an erasure.
+   * Failing to trim is not an error, so the old storage is kept on any
+   * exception.
+   */
+  void _trim() {
+    size_type capacity = Policy::shrunk_capacity(_capacity, _size);
+    if (capacity >= _capacity)
+      return;
+    try {
+      _reallocate(capacity);
+    } catch (...) {
+    }
+  }
+
+  /**
+   * @brief Capacity to reallocate to so that n more elements fit.
+   * @throws std::length_error if the result would exceed max_size().
+   */
+  size_type _next_capacity(size_type n) const {
+    if (n > max_size() - _size)
+      throw std::length_error("ft::vector: capacity exceeds max_size()");
+    size_type capacity = Policy::next_capacity(_capacity, _size + n);
+    if (capacity < _size + n || capacity > max_size())
+      capacity = max_size();
+    return capacity;
+  }
+
+  /**
+   * @brief Opens a gap of n uninitialized slots at offset.
+   *
+   * Within capacity, the suffix is shifted right. Otherwise the vector
+   * reallocates once, to _next_capacity(n), and relocates the prefix and the
+   * suffix straight to their final places around the gap.
+   *
+   * @return A pointer to the first slot of the gap.
+   */
+  pointer _open_gap(size_type offset, size_type n) {
+    if (_size + n <= _capacity) {
+      _relocate(_data + offset + n, _data + offset, _size - offset,
+                _is_trivial());
+      return _data + offset;
+    }
+    size_type capacity = _next_capacity(n);
+    pointer tmp = _allocate(capacity);
+    try {
+      _copy_around_gap(tmp, offset, n);
+    } catch (...) {
+      _deallocate(tmp, capacity);
+      throw;
+    }
+    _adopt(tmp, capacity);
+    return _data + offset;
+  }
+
+  /**
+   * @brief Copies the elements to dest, leaving n uninitialized slots at
+   * offset. Whatever was copied is destroyed again if a copy throws.
+   */
+  void _copy_around_gap(pointer dest, size_type offset, size_type n) {
+    _uninitialized_relocate(dest, _data, offset, _is_trivial());
+    try {
+      _uninitialized_relocate(dest + offset + n, _data + offset,
+                              _size - offset, _is_trivial());
+    } catch (...) {
+      _destroy(dest, offset);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Releases the current storage in favor of data, which already
+   * holds copies of the elements.
+   */
+  void _adopt(pointer data, size_type capacity) {
+    _destroy(_data, _size);
+    _deallocate(_data, _capacity);
+    _data = data;
+    _capacity = capacity;
+  }
+
+  /**
+   * @brief Constructs an element from args at offset.
+   *
+   * At the end, or when the vector reallocates, the element is built in its
+   * final slot, before any existing element moves, so args may refer into
+   * the vector. Shifting the suffix could move an argument instead, so a
+   * middle insertion within capacity builds the value aside first.
+   */
+  template <class Args> void _emplace(size_type offset, const Args &args) {
+    if (_size == _capacity) {
+      size_type capacity = _next_capacity(1);
+      pointer tmp = _allocate(capacity);
+      try {
+        args.construct(tmp + offset);
+      } catch (...) {
+        _deallocate(tmp, capacity);
+        throw;
+      }
+      try {
+        _copy_around_gap(tmp, offset, 1);
+      } catch (...) {
+        _destroy(tmp + offset, 1);
+        _deallocate(tmp, capacity);
+        throw;
+      }
+      _adopt(tmp, capacity);
+    } else if (offset == _size) {
+      args.construct(_data + _size);
+    } else {
+      value_type val(args.template make<value_type>());
+      pointer gap = _open_gap(offset, 1);
+      try {
+        _construct_relocated(gap, &val);
+      } catch (...) {
+        _close_gap(offset, 1, 0);
+        throw;
+      }
+    }
+    _size++;
+  }
+
+  /**
+   * @brief Closes a gap opened by _open_gap(offset, n) after constructing
+   * only its first constructed slots failed.
+   */
+  void _close_gap(size_type offset, size_type n, size_type constructed) {
+    _destroy(_data + offset, constructed);
+    _relocate(_data + offset, _data + offset + n, _size - offset,
+              _is_trivial());
+  }
+
 public:
   // Member functions
 
@@ -63,7 +393,7 @@ public:
    */
   explicit vector(const allocator_type &alloc = allocator_type())
       : _data(NULL), _size(0), _capacity(_init_capacity), _alloc(alloc) {
-    _data = _alloc.allocate(_capacity);
+    _data = _allocate(_capacity);
   };
 
   /**
@@ -81,7 +411,7 @@ public:
     if (n > max_size())
       throw std::length_error("ft::vector::vector(size_type, const "
                               "value_type&, const allocator_type&)");
-    _data = _alloc.allocate(_size * sizeof(value_type));
+    _data = _allocate(_capacity);
     for (size_type i = 0; i < _size; i++) {
       _alloc.construct(_data + i, val);
     }
@@ -107,9 +437,9 @@ public:
       : _alloc(alloc) {
     _size = ft::distance(first, last);
     _capacity = _size < _init_capacity ? _init_capacity : _size;
-    _data = _alloc.allocate(_capacity * sizeof(value_type));
-    for (size_type i = 0; i < _size; i++) {
-      _alloc.construct(_data + i, *(first + i));
+    _data = _allocate(_capacity);
+    for (size_type i = 0; i < _size; i++, ++first) {
+      _alloc.construct(_data + i, *first);
     }
   }
 
@@ -120,13 +450,30 @@ public:
    * Creates a vector with the same elements as the given vector.
    */
   vector(const vector &x)
-      : _size(x._size), _capacity(x._capacity), _alloc(Alloc(x._alloc)) {
-    _data = _alloc.allocate(_capacity * sizeof(value_type));
-    for (size_type i = 0; i < _size; i++) {
-      _alloc.construct(_data + i, x._data[i]);
+      : _size(x._size), _capacity(x._size), _alloc(Alloc(x._alloc)) {
+    _data = _allocate(_capacity);
+    try {
+      _uninitialized_copy(_data, x._data, _size, _is_trivial());
+    } catch (...) {
+      _deallocate(_data, _capacity);
+      throw;
     }
   }
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Takes over the storage of x, which is left
+   * empty.
+   */
+  vector(vector &&x) noexcept
+      : _data(x._data), _size(x._size), _capacity(x._capacity),
+        _alloc(std::move(x._alloc)) {
+    x._data = NULL;
+    x._size = 0;
+    x._capacity = 0;
+  }
+#endif
+
   /**
    * @brief Default destructor.
    * Deallocates the memory used by the vector.
@@ -137,12 +484,8 @@ public:
    * and the vector is empty.
    */
   ~vector() {
-    if (_data != NULL) {
-      for (size_type i = 0; i < _size; i++) {
-        _alloc.destroy(_data + i);
-      }
-      _alloc.deallocate(_data, _capacity * sizeof(value_type));
-    }
+    _destroy(_data, _size);
+    _deallocate(_data, _capacity);
   }
 
   /**
@@ -154,23 +497,42 @@ public:
    */
   vector &operator=(const vector &x) {
     if (this != &x) {
-      if (_size != x._size) {
-        if (_data != NULL) {
-          for (size_type i = 0; i < _size; i++) {
-            _alloc.destroy(_data + i);
-          }
-          _alloc.deallocate(_data, _capacity * sizeof(value_type));
-        }
-        _size = x._size;
-        _capacity = x._capacity;
-        _data = _alloc.allocate(_capacity * sizeof(value_type));
-      }
-      for (size_type i = 0; i < _size; i++) {
-        _alloc.construct(_data + i, x._data[i]);
-      }
+      _destroy(_data, _size);
+      _size = 0;
+      _reallocate_empty(x._size);
+      _uninitialized_copy(_data, x._data, x._size, _is_trivial());
+      _size = x._size;
+    }
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move assignment operator. Takes over the storage of x when the
+   * allocators compare equal, and moves the elements one by one otherwise.
+   */
+  vector &operator=(vector &&x) {
+    if (this == &x)
+      return *this;
+    _destroy(_data, _size);
+    _size = 0;
+    if (_alloc == x._alloc) {
+      _deallocate(_data, _capacity);
+      _data = x._data;
+      _size = x._size;
+      _capacity = x._capacity;
+      x._data = NULL;
+      x._size = 0;
+      x._capacity = 0;
+    } else {
+      _reallocate_empty(x._size);
+      for (; _size < x._size; _size++)
+        ::new (static_cast<void *>(_data + _size))
+            value_type(std::move(x._data[_size]));
     }
     return *this;
   }
+#endif
 
   // Iterators
 
@@ -267,16 +629,16 @@ public:
    */
   void resize(size_type n, value_type val = value_type()) {
     if (n > _size) {
-      reserve(n);
-      for (size_type i = _size; i < n; i++) {
-        _alloc.construct(_data + i, val);
+      if (n > _capacity)
+        reserve(_next_capacity(n - _size));
+      for (; _size < n; _size++) {
+        _alloc.construct(_data + _size, val);
       }
     } else if (n < _size) {
-      for (size_type i = n; i < _size; i++) {
-        _alloc.destroy(_data + i);
-      }
+      _destroy(_data + n, _size - n);
+      _size = n;
+      _trim();
     }
-    _size = n;
   }
 
   /**
@@ -312,16 +674,18 @@ public:
       throw std::length_error("ft::vector::reserve");
     }
     if (n > _capacity) {
-      _capacity = n;
-      pointer tmp = _alloc.allocate(_capacity * sizeof(value_type));
-      for (size_type i = 0; i < _size; i++) {
-        _alloc.construct(tmp + i, _data[i]);
-      }
-      for (size_type i = 0; i < _size; i++) {
-        _alloc.destroy(_data + i);
-      }
-      _alloc.deallocate(_data, _size * sizeof(value_type));
-      _data = tmp;
+      _reallocate(n);
+    }
+  }
+
+  /**
+   * @brief Reduces the capacity to size(), releasing the unused storage.
+   *
+   * @return none
+   */
+  void shrink_to_fit() {
+    if (_capacity > _size) {
+      _reallocate(_size);
     }
   }
 
@@ -422,16 +786,12 @@ public:
     if (n > max_size()) {
       throw std::length_error("ft::vector::assign");
     }
-    if (n > capacity()) {
-      reserve(n);
-    }
-    for (size_type i = 0; i < n; i++) {
-      _alloc.construct(_data + i, *(first + i));
-    }
-    for (size_type i = n; i < _size; i++) {
-      _alloc.destroy(_data + i);
+    _destroy(_data, _size);
+    _size = 0;
+    _reallocate_empty(n);
+    for (; _size < n; _size++, ++first) {
+      _alloc.construct(_data + _size, *first);
     }
-    _size = n;
   }
 
   /**
@@ -448,16 +808,13 @@ public:
     if (n > max_size()) {
       throw std::length_error("ft::vector::assign");
     }
-    if (n > capacity()) {
-      reserve(n);
-    }
-    for (size_type i = 0; i < n; i++) {
-      _alloc.construct(&(*(begin() + i)), val);
-    }
-    for (size_type i = n; i < _size; i++) {
-      _alloc.destroy(&(*(begin() + i)));
+    value_type copy(val); // val may refer to an element about to go
+    _destroy(_data, _size);
+    _size = 0;
+    _reallocate_empty(n);
+    for (; _size < n; _size++) {
+      _alloc.construct(_data + _size, copy);
     }
-    _size = n;
   }
 
   /**
@@ -470,12 +827,46 @@ public:
    */
   void push_back(const value_type &val) {
     if (_size == capacity()) {
-      reserve(capacity() ? capacity() * _growth_factor : 1);
+      value_type copy(val); // val may refer to an element about to move
+      reserve(_next_capacity(1));
+      _alloc.construct(_data + _size, copy);
+    } else {
+      _alloc.construct(_data + _size, val);
     }
-    _alloc.construct(&(*(begin() + size())), val);
     _size++;
   };
 
+#if FT_HAS_MOVE
+  /**
+   * @brief Adds an element at the end, moved from val.
+   */
+  void push_back(value_type &&val) {
+    _emplace(_size, ft::make_emplace_move_args(val));
+  }
+#endif
+
+  /**
+   * @brief Appends an element constructed in place from the given arguments.
+   *
+   * Overloads take up to three arguments, forwarded as const references.
+   * Unlike push_back, no value_type is constructed outside the container.
+   */
+  void emplace_back() { _emplace(_size, ft::make_emplace_args()); }
+
+  template <class A1> void emplace_back(const A1 &a1) {
+    _emplace(_size, ft::make_emplace_args(a1));
+  }
+
+  template <class A1, class A2>
+  void emplace_back(const A1 &a1, const A2 &a2) {
+    _emplace(_size, ft::make_emplace_args(a1, a2));
+  }
+
+  template <class A1, class A2, class A3>
+  void emplace_back(const A1 &a1, const A2 &a2, const A3 &a3) {
+    _emplace(_size, ft::make_emplace_args(a1, a2, a3));
+  }
+
   /**
    * @brief Removes the last element in the container.
    *
@@ -486,6 +877,7 @@ public:
     if (_size > 0) {
       _alloc.destroy(_data + _size - 1);
       _size--;
+      _trim();
     } else {
       throw std::out_of_range("ft::vector::pop_back");
     }
@@ -502,16 +894,67 @@ public:
    */
   iterator insert(iterator position, const value_type &val) {
     size_type _offset = position - begin();
-    if (_size == capacity()) {
-      reserve(capacity() * _growth_factor);
-    }
-    for (size_type i = _size; i > _offset; i--) {
-      _alloc.construct(&(*begin()) + i, *(begin() + i - 1));
+    value_type copy(val); // val may refer to an element about to move
+    pointer gap = _open_gap(_offset, 1);
+    try {
+      _alloc.construct(gap, copy);
+    } catch (...) {
+      _close_gap(_offset, 1, 0);
+      throw;
     }
-    _alloc.construct(&(*begin()) + _offset, val);
     _size++;
-    return iterator(begin() + _offset);
+    return iterator(gap);
+  }
+
+  /**
+   * @brief Inserts an element constructed from the given arguments before
+   * position.
+   *
+   * Overloads take up to three arguments, forwarded as const references.
+   * The element is constructed in place at the end or when the vector
+   * reallocates, and copied into place otherwise.
+   *
+   * @return iterator to the newly inserted element.
+   */
+  iterator emplace(iterator position) {
+    size_type offset = position - begin();
+    _emplace(offset, ft::make_emplace_args());
+    return begin() + offset;
+  }
+
+  template <class A1> iterator emplace(iterator position, const A1 &a1) {
+    size_type offset = position - begin();
+    _emplace(offset, ft::make_emplace_args(a1));
+    return begin() + offset;
+  }
+
+  template <class A1, class A2>
+  iterator emplace(iterator position, const A1 &a1, const A2 &a2) {
+    size_type offset = position - begin();
+    _emplace(offset, ft::make_emplace_args(a1, a2));
+    return begin() + offset;
+  }
+
+  template <class A1, class A2, class A3>
+  iterator emplace(iterator position, const A1 &a1, const A2 &a2,
+                   const A3 &a3) {
+    size_type offset = position - begin();
+    _emplace(offset, ft::make_emplace_args(a1, a2, a3));
+    return begin() + offset;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Inserts an element moved from val before position.
+   *
+   * @return iterator to the newly inserted element.
+   */
+  iterator insert(iterator position, value_type &&val) {
+    size_type offset = position - begin();
+    _emplace(offset, ft::make_emplace_move_args(val));
+    return begin() + offset;
   }
+#endif
 
   /**
    * @brief Inserts n copies of val at position position.
@@ -524,14 +967,16 @@ public:
    */
   void insert(iterator position, size_type n, const value_type &val) {
     size_type _offset = position - begin();
-    if (_size + n > capacity()) {
-      reserve(capacity() * _growth_factor);
-    }
-    for (size_type i = _size; i > _offset; i--) {
-      _alloc.construct(&(*begin()) + i + n - 1, *(begin() + i - 1));
-    }
-    for (size_type i = 0; i < n; i++) {
-      _alloc.construct(&(*begin()) + _offset + i, val);
+    value_type copy(val); // val may refer to an element about to move
+    pointer gap = _open_gap(_offset, n);
+    size_type i = 0;
+    try {
+      for (; i < n; i++) {
+        _alloc.construct(gap + i, copy);
+      }
+    } catch (...) {
+      _close_gap(_offset, n, i);
+      throw;
     }
     _size += n;
   }
@@ -554,14 +999,15 @@ public:
           0) {
     size_type _offset = position - begin();
     size_type n = ft::distance(first, last);
-    if (_size + n > _capacity) {
-      reserve(capacity() * _growth_factor);
-    }
-    for (size_type i = _size; i > _offset; i--) {
-      _alloc.construct(&(*begin()) + i + n - 1, *(begin() + i - 1));
-    }
-    for (size_type i = 0; i < n; i++) {
-      _alloc.construct(&(*begin()) + _offset + i, *(first + i));
+    pointer gap = _open_gap(_offset, n);
+    size_type i = 0;
+    try {
+      for (; i < n; i++, ++first) {
+        _alloc.construct(gap + i, *first);
+      }
+    } catch (...) {
+      _close_gap(_offset, n, i);
+      throw;
     }
     _size += n;
   };
@@ -580,12 +1026,13 @@ public:
     if (size() == 0 || position >= end() || position < begin()) {
       throw std::out_of_range("ft::vector::erase");
     }
-    for (size_type i = position - _data; i < _size - 1; i++) {
-      _alloc.construct(_data + i, _data[i + 1]);
-    }
-    _alloc.destroy(_data + _size - 1);
+    pointer p = &(*position);
+    _alloc.destroy(p);
+    _relocate(p, p + 1, end() - position - 1, _is_trivial());
     _size--;
-    return position;
+    size_type offset = p - _data;
+    _trim();
+    return iterator(_data + offset);
   };
 
   /**
@@ -604,18 +1051,20 @@ public:
     if (size() == 0 || first >= end() || last < begin()) {
       throw std::out_of_range("ft::vector::erase");
     }
-    for (iterator it = first; it != last; it++) {
-      _alloc.destroy(&(*it));
-    }
-    for (iterator it = last; it != end(); it++) {
-      _alloc.construct(&(*(it - (last - first))), *it);
-    }
-    _size -= last - first;
-    return first;
+    pointer p = &(*first);
+    size_type n = last - first;
+    _destroy(p, n);
+    _relocate(p, p + n, end() - last, _is_trivial());
+    _size -= n;
+    size_type offset = p - _data;
+    _trim();
+    return iterator(_data + offset);
   };
 
   /**
-   * @brief Swaps the contents of the container with those of other.
+   * @brief Swaps the contents of the container with those of other, in
+   * constant time and without copying elements. The allocators are swapped
+   * as well if ft::propagate_on_container_swap holds for allocator_type.
    * @param other The container to swap with.
    * @return none
    */
@@ -623,18 +1072,19 @@ public:
     ft::swap(_data, x._data);
     ft::swap(_size, x._size);
     ft::swap(_capacity, x._capacity);
+    _swap_allocator(x, ft::propagate_on_container_swap<allocator_type>());
   };
 
   /**
    * @brief Clears the contents of the container. After this call, size()
-   * returns zero. Does not deallocate memory.
+   * returns zero. Does not deallocate memory, unless the policy trims the
+   * capacity after erasures.
    * @return none
    */
   void clear() {
-    for (iterator it = begin(); it != end(); ++it) {
-      _alloc.destroy(&(*it));
-    }
+    _destroy(_data, _size);
     _size = 0;
+    _trim();
   };
 
   // Allocator
@@ -654,8 +1104,9 @@ public:
  * @param rhs The second vector.
  * @return true if the two vectors are equal, false otherwise.
  */
-template <class T, class Alloc>
-bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator==(const vector<T, Alloc, Policy> &lhs,
+                const vector<T, Alloc, Policy> &rhs) {
   if (lhs.size() != rhs.size()) {
     return false;
   }
@@ -668,8 +1119,9 @@ bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @param rhs The second vector.
  * @return true if the two vectors are not equal, false otherwise.
  */
-template <class T, class Alloc>
-bool operator!=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator!=(const vector<T, Alloc, Policy> &lhs,
+                const vector<T, Alloc, Policy> &rhs) {
   return !(lhs == rhs);
 }
 
@@ -679,8 +1131,9 @@ bool operator!=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @param rhs The second vector.
  * @return true if the first vector is less than the second, false otherwise.
  */
-template <class T, class Alloc>
-bool operator<(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator<(const vector<T, Alloc, Policy> &lhs,
+               const vector<T, Alloc, Policy> &rhs) {
   return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                      rhs.end());
 }
@@ -692,8 +1145,9 @@ bool operator<(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @return true if the first vector is greater than the second, false
  * otherwise.
  */
-template <class T, class Alloc>
-bool operator>(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator>(const vector<T, Alloc, Policy> &lhs,
+               const vector<T, Alloc, Policy> &rhs) {
   return rhs < lhs;
 }
 
@@ -704,8 +1158,9 @@ bool operator>(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @return true if the first vector is less than or equal to the second, false
  * otherwise.
  */
-template <class T, class Alloc>
-bool operator<=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator<=(const vector<T, Alloc, Policy> &lhs,
+                const vector<T, Alloc, Policy> &rhs) {
   return !(rhs < lhs);
 }
 
@@ -716,8 +1171,9 @@ bool operator<=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @return true if the first vector is greater than or equal to the second,
  * false otherwise.
  */
-template <class T, class Alloc>
-bool operator>=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
+template <class T, class Alloc, class Policy>
+bool operator>=(const vector<T, Alloc, Policy> &lhs,
+                const vector<T, Alloc, Policy> &rhs) {
   return !(lhs < rhs);
 }
 
@@ -727,8 +1183,165 @@ bool operator>=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
  * @param rhs The second vector.
  * @return none
  */
-template <class T, class Alloc>
-void swap(vector<T, Alloc> &x, vector<T, Alloc> &y) {
+template <class T, class Alloc, class Policy>
+void swap(vector<T, Alloc, Policy> &x, vector<T, Alloc, Policy> &y) {
+  x.swap(y);
+}
+
+/**
+ * @brief A vector that keeps up to N elements inline and spills to the heap
+ * only beyond that.
+ *
+ * The inline buffer lives in the vector's ft::small_buffer_allocator, so a
+ * small_vector is an ft::vector and offers the same interface. It starts with
+ * a capacity of N and uses the inline buffer exactly while capacity() is N;
+ * growing past N moves the elements to the heap, and shrink_to_fit() brings
+ * them back once they fit. swap() exchanges heap storage in constant time but
+ * has to copy the elements when either vector is inline.
+ *
+ * @tparam T The type of the elements.
+ * @tparam N The number of elements stored inline.
+ * @tparam Alloc The allocator used once the elements spill to the heap.
+ */
+template <class T, std::size_t N, class Alloc = std::allocator<T>>
+class small_vector : public vector<T, small_buffer_allocator<T, N, Alloc>> {
+  typedef vector<T, small_buffer_allocator<T, N, Alloc>> _base;
+
+public:
+  typedef typename _base::value_type value_type;
+  typedef typename _base::allocator_type allocator_type;
+  typedef typename _base::size_type size_type;
+
+  // Member functions
+
+  /**
+   * @brief Default constructor. Creates an empty vector with room for N
+   * elements inline.
+   */
+  explicit small_vector(const Alloc &alloc = Alloc())
+      : _base(allocator_type(alloc)) {
+    this->reserve(N);
+  }
+
+  /**
+   * @brief Fill constructor. Creates a vector with n copies of val.
+   */
+  explicit small_vector(size_type n, const value_type &val = value_type(),
+                        const Alloc &alloc = Alloc())
+      : _base(allocator_type(alloc)) {
+    this->reserve(n < N ? N : n);
+    this->assign(n, val);
+  }
+
+  /**
+   * @brief Range constructor. Creates a vector with the elements in the
+   * range [first, last).
+   */
+  template <class InputIterator>
+  small_vector(
+      InputIterator first, InputIterator last, const Alloc &alloc = Alloc(),
+      typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type * =
+          0)
+      : _base(allocator_type(alloc)) {
+    this->reserve(N);
+    this->assign(first, last);
+  }
+
+  /**
+   * @brief Copy constructor. The copy is inline whenever its elements fit.
+   */
+  small_vector(const small_vector &x)
+      : _base(allocator_type(x.get_allocator().upstream())) {
+    this->reserve(x.size() < N ? N : x.size());
+    this->assign(x.begin(), x.end());
+  }
+
+  small_vector &operator=(const small_vector &x) {
+    _base::operator=(x);
+    return *this;
+  }
+
+#if FT_HAS_MOVE
+  /**
+   * @brief Move constructor. Heap storage is taken over, leaving x empty
+   * and inline; inline elements are moved one by one.
+   */
+  small_vector(small_vector &&x)
+      : _base(allocator_type(x.get_allocator().upstream())) {
+    if (x._is_inline()) {
+      this->reserve(N);
+      for (size_type i = 0; i < x.size(); i++)
+        this->push_back(std::move(x[i]));
+    } else {
+      _base::swap(x);
+      x.reserve(N);
+    }
+  }
+
+  /**
+   * @brief Move assignment operator. Heap storage changes hands when both
+   * vectors are on the heap; otherwise the elements are moved one by one.
+   */
+  small_vector &operator=(small_vector &&x) {
+    if (this == &x)
+      return *this;
+    if (!_is_inline() && !x._is_inline()) {
+      _base::swap(x);
+      x.clear();
+    } else {
+      _base::operator=(std::move(x));
+    }
+    return *this;
+  }
+#endif
+
+  // Capacity
+
+  /**
+   * @brief Releases unused heap storage, moving the elements back inline if
+   * they fit.
+   */
+  void shrink_to_fit() {
+    if (this->size() > N)
+      _base::shrink_to_fit();
+    else if (!_is_inline())
+      this->_reallocate(N);
+  }
+
+  // Modifiers
+
+  /**
+   * @brief Swaps the contents of two vectors. Heap storage is exchanged in
+   * constant time; inline elements cannot change hands, so they are copied,
+   * or moved when move support is enabled.
+   */
+  void swap(small_vector &x) {
+    if (!_is_inline() && !x._is_inline()) {
+      _base::swap(x);
+      return;
+    }
+#if FT_HAS_MOVE
+    small_vector tmp(std::move(*this));
+    *this = std::move(x);
+    x = std::move(tmp);
+#else
+    small_vector tmp(*this);
+    *this = x;
+    x = tmp;
+#endif
+  }
+
+private:
+  // Heap storage always has room for more than N elements
+  bool _is_inline() const { return this->capacity() == N; }
+};
+
+/**
+ * @brief Swaps the contents of two small vectors. Equivalent to
+ * lhs.swap(rhs).
+ */
+template <class T, std::size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc> &x, small_vector<T, N, Alloc> &y) {
   x.swap(y);
 }
 
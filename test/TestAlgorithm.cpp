@@ -157,3 +157,22 @@ TEST(TestLexicographicalCompare, TestLexicographicalCompareCompFunc) {
   EXPECT_TRUE(ft::lexicographical_compare(m1.begin(), m1.end(), m2.begin(),
                                           m2.end(), comp_map));
 }
+
+// Tests ft::_merge_sort
+
+static bool comp_first(std::pair<int, int> a, std::pair<int, int> b) {
+  return a.first < b.first;
+}
+
+TEST(TestMergeSort, TestMergeSortStable) {
+  for (int n = 0; n < 200; n += 7) {
+    std::vector<std::pair<int, int>> v;
+    for (int i = 0; i < n; i++)
+      v.push_back(std::make_pair((i * 37) % 11, i));
+    std::vector<std::pair<int, int>> buffer(v);
+    std::vector<std::pair<int, int>> expected(v);
+    std::stable_sort(expected.begin(), expected.end(), comp_first);
+    ft::_merge_sort(v.begin(), v.end(), buffer.begin(), comp_first);
+    EXPECT_EQ(v, expected);
+  }
+}
@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+
+#include "flat_map.hpp"
+#include "flat_set.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+typedef ft::flat_map<int, std::string> flat_map_type;
+typedef ft::flat_set<int> flat_set_type;
+
+template <class FlatMap, class Map>
+static bool has_same_elements(const FlatMap &fm, const Map &m) {
+  if (fm.size() != m.size())
+    return false;
+  typename Map::const_iterator it = m.begin();
+  for (typename FlatMap::const_iterator fit = fm.begin(); fit != fm.end();
+       ++fit, ++it)
+    if ((*fit).first != it->first || fit->second != it->second)
+      return false;
+  return true;
+}
+
+template <class FlatSet, class Set>
+static bool has_same_keys(const FlatSet &fs, const Set &s) {
+  return fs.size() == s.size() && ft::equal(s.begin(), s.end(), fs.begin());
+}
+
+// Tests ft::flat_map
+
+TEST(TestFlatMap, TestFlatMapInsert) {
+  flat_map_type fm;
+  std::map<int, std::string> m;
+  for (int i = 0; i < 1000; i++) {
+    int k = (i * 7919) % 500;
+    std::string v(1, 'a' + i % 26);
+    EXPECT_EQ(fm.insert(flat_map_type::value_type(k, v)).second,
+              m.insert(std::make_pair(k, v)).second);
+  }
+  EXPECT_TRUE(has_same_elements(fm, m));
+  EXPECT_EQ(fm.keys().size(), fm.values().size());
+
+  ft::pair<flat_map_type::iterator, bool> res =
+      fm.insert(flat_map_type::value_type(3, "x"));
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(res.first->first, 3);
+  res.first->second = "x";
+  EXPECT_EQ(fm.at(3), "x");
+
+  fm[1000] = "y";
+  EXPECT_EQ((*fm.rbegin()).second, "y");
+  EXPECT_THROW(fm.at(-1), std::out_of_range);
+}
+
+TEST(TestFlatMap, TestFlatMapReverseIterators) {
+  flat_map_type fm;
+  for (int i = 0; i < 10; i++)
+    fm[i] = std::string(1, 'a' + i);
+  EXPECT_EQ(fm.rbegin()->first, 9);
+  fm.rbegin()->second = "z";
+  EXPECT_EQ(fm.crbegin()->second, "z");
+  EXPECT_EQ((++fm.crbegin())->first, 8);
+
+  const flat_map_type &cfm = fm;
+  int k = 9;
+  for (flat_map_type::const_reverse_iterator it = cfm.rbegin();
+       it != cfm.crend(); ++it, --k)
+    EXPECT_EQ(it->first, k);
+  EXPECT_EQ(k, -1);
+  EXPECT_TRUE(fm.cbegin() == cfm.begin());
+  EXPECT_TRUE(fm.cend() == cfm.end());
+}
+
+TEST(TestFlatMap, TestFlatMapLookup) {
+  flat_map_type fm;
+  for (int i = 0; i < 100; i += 2)
+    fm[i] = std::string(1, 'a' + i % 26);
+
+  EXPECT_EQ(fm.find(10)->second, "k");
+  EXPECT_TRUE(fm.find(11) == fm.end());
+  EXPECT_EQ(fm.count(10), 1);
+  EXPECT_EQ(fm.count(11), 0);
+  EXPECT_EQ(fm.lower_bound(11)->first, 12);
+  EXPECT_EQ(fm.upper_bound(12)->first, 14);
+  EXPECT_TRUE(fm.upper_bound(98) == fm.end());
+  ft::pair<flat_map_type::iterator, flat_map_type::iterator> range =
+      fm.equal_range(20);
+  EXPECT_EQ(range.second - range.first, 1);
+  range = fm.equal_range(21);
+  EXPECT_TRUE(range.first == range.second);
+
+  const flat_map_type &cfm = fm;
+  flat_map_type::const_iterator it = cfm.find(40);
+  EXPECT_TRUE(it == fm.find(40));
+  EXPECT_EQ(it - cfm.begin(), 20);
+  EXPECT_EQ(it[1].first, 42);
+}
+
+TEST(TestFlatMap, TestFlatMapBatchInsert) {
+  std::vector<ft::pair<int, int>> batch;
+  std::map<int, int> m;
+  for (int i = 0; i < 2000; i++) {
+    int k = (i * 997) % 1500;
+    batch.push_back(ft::make_pair(k, i));
+    m.insert(std::make_pair(k, i));
+  }
+
+  ft::flat_map<int, int> fm(batch.begin(), batch.end());
+  EXPECT_TRUE(has_same_elements(fm, m));
+
+  // Keys already present win over the batch
+  std::vector<ft::pair<int, int>> more;
+  for (int i = 0; i < 3000; i += 3) {
+    more.push_back(ft::make_pair(i, -i));
+    m.insert(std::make_pair(i, -i));
+  }
+  fm.insert(more.begin(), more.end());
+  EXPECT_TRUE(has_same_elements(fm, m));
+
+  // A sorted batch past the last key is appended
+  std::vector<ft::pair<int, int>> tail;
+  for (int i = 5000; i < 5100; i++) {
+    tail.push_back(ft::make_pair(i, i));
+    m.insert(std::make_pair(i, i));
+  }
+  fm.insert(ft::sorted_unique, tail.begin(), tail.end());
+  EXPECT_TRUE(has_same_elements(fm, m));
+}
+
+TEST(TestFlatMap, TestFlatMapContainers) {
+  ft::vector<int> keys;
+  ft::vector<int> values;
+  for (int i = 0; i < 100; i++) {
+    keys.push_back(i * 2);
+    values.push_back(i);
+  }
+
+  ft::flat_map<int, int> sorted(ft::sorted_unique, keys, values);
+  EXPECT_TRUE(sorted.keys() == keys);
+
+  keys.push_back(0);
+  values.push_back(-1);
+  ft::vector<int> rkeys;
+  ft::vector<int> rvalues;
+  for (int i = 100; i >= 0; i--) {
+    rkeys.push_back(keys[i]);
+    rvalues.push_back(values[i]);
+  }
+  ft::flat_map<int, int> unsorted(rkeys, rvalues);
+  EXPECT_EQ(unsorted.size(), 100);
+  EXPECT_EQ(unsorted.at(0), -1);
+  EXPECT_EQ(unsorted.at(198), 99);
+  unsorted[0] = 0;
+  EXPECT_TRUE(unsorted == sorted);
+}
+
+TEST(TestFlatMap, TestFlatMapErase) {
+  ft::flat_map<int, int> fm;
+  std::map<int, int> m;
+  for (int i = 0; i < 500; i++) {
+    fm[i] = i;
+    m[i] = i;
+  }
+  for (int i = 0; i < 500; i += 3) {
+    EXPECT_EQ(fm.erase(i), 1);
+    m.erase(i);
+  }
+  EXPECT_EQ(fm.erase(0), 0);
+  EXPECT_TRUE(has_same_elements(fm, m));
+
+  ft::flat_map<int, int>::iterator it = fm.erase(fm.find(4));
+  m.erase(4);
+  EXPECT_EQ(it->first, 5);
+  it = fm.erase(fm.lower_bound(100), fm.lower_bound(200));
+  m.erase(m.lower_bound(100), m.lower_bound(200));
+  EXPECT_EQ(it->first, 200);
+  EXPECT_TRUE(has_same_elements(fm, m));
+}
+
+TEST(TestFlatMap, TestFlatMapCopy) {
+  ft::flat_map<int, int> fm;
+  for (int i = 0; i < 100; i++)
+    fm[i] = i;
+  ft::flat_map<int, int> copy(fm);
+  EXPECT_TRUE(copy == fm);
+  copy[0] = 1;
+  EXPECT_TRUE(copy != fm);
+  fm.clear();
+  ft::swap(copy, fm);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(fm.size(), 100);
+  copy = fm;
+  EXPECT_TRUE(copy == fm);
+}
+
+// Tests ft::flat_set
+
+TEST(TestFlatSet, TestFlatSetInsert) {
+  flat_set_type fs;
+  std::set<int> s;
+  for (int i = 0; i < 1000; i++) {
+    int k = (i * 7919) % 500;
+    EXPECT_EQ(fs.insert(k).second, s.insert(k).second);
+  }
+  EXPECT_TRUE(has_same_keys(fs, s));
+  EXPECT_EQ(*fs.find(42), 42);
+  EXPECT_TRUE(fs.find(500) == fs.end());
+  EXPECT_EQ(*fs.upper_bound(42), 43);
+  EXPECT_EQ(fs.count(499), 1);
+}
+
+TEST(TestFlatSet, TestFlatSetReverseIterators) {
+  ft::flat_set<std::string> fs;
+  fs.insert("ab");
+  fs.insert("xyz");
+  EXPECT_EQ(fs.rbegin()->size(), 3);
+  EXPECT_EQ((++fs.rbegin())->size(), 2);
+}
+
+TEST(TestFlatSet, TestFlatSetBatchInsert) {
+  std::vector<int> batch;
+  for (int i = 0; i < 2000; i++)
+    batch.push_back((i * 997) % 1500);
+  std::set<int> s(batch.begin(), batch.end());
+
+  flat_set_type fs(batch.begin(), batch.end());
+  EXPECT_TRUE(has_same_keys(fs, s));
+
+  for (int i = 0; i < 3000; i += 3)
+    batch.push_back(i);
+  s.insert(batch.begin(), batch.end());
+  fs.insert(batch.begin(), batch.end());
+  EXPECT_TRUE(has_same_keys(fs, s));
+
+  ft::vector<int> keys(fs.begin(), fs.end());
+  flat_set_type sorted(ft::sorted_unique, keys);
+  EXPECT_TRUE(sorted == fs);
+}
+
+TEST(TestFlatSet, TestFlatSetErase) {
+  std::set<int> s;
+  for (int i = 0; i < 500; i++)
+    s.insert(i);
+  flat_set_type fs(ft::sorted_unique, s.begin(), s.end());
+  for (int i = 0; i < 500; i += 3) {
+    EXPECT_EQ(fs.erase(i), 1);
+    s.erase(i);
+  }
+  EXPECT_TRUE(has_same_keys(fs, s));
+
+  flat_set_type::iterator it = fs.erase(fs.lower_bound(100), fs.find(200));
+  s.erase(s.lower_bound(100), s.find(200));
+  EXPECT_EQ(*it, 200);
+  EXPECT_EQ(*fs.erase(it), 202);
+  s.erase(200);
+  EXPECT_TRUE(has_same_keys(fs, s));
+}
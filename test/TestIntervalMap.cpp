@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "interval_map.hpp"
+#include <iterator>
+#include <vector>
+
+typedef ft::interval_map<int, int> interval_map_type;
+typedef std::vector<interval_map_type::const_iterator> result_type;
+
+// The elements overlapping [lo, hi), or containing lo if closed, by scan
+static result_type scan(const interval_map_type &m, int lo, int hi,
+                        bool closed) {
+  result_type found;
+  for (interval_map_type::const_iterator it = m.begin(); it != m.end(); ++it)
+    if ((closed ? it->first.first <= hi : it->first.first < hi) &&
+        lo < it->first.second)
+      found.push_back(it);
+  return found;
+}
+
+static bool has_valid_queries(const interval_map_type &m) {
+  for (int lo = -10; lo < 1100; lo += 7) {
+    for (int len = 0; len < 60; len += 13) {
+      result_type found;
+      m.overlapping(lo, lo + len, std::back_inserter(found));
+      if (found != scan(m, lo, lo + len, false))
+        return false;
+    }
+    result_type found;
+    m.stabbing(lo, std::back_inserter(found));
+    if (found != scan(m, lo, lo, true))
+      return false;
+  }
+  return true;
+}
+
+class TestIntervalMap : public ::testing::Test {
+protected:
+  interval_map_type m;
+
+  // Intervals of scrambled starts and lengths, some of them nested
+  void SetUp() {
+    for (int i = 0; i < 1000; i++) {
+      int start = (i * 7919) % 1000;
+      m.insert(start, start + (i * 31) % 50, i);
+    }
+  }
+};
+
+TEST_F(TestIntervalMap, TestIntervalMapInsert) {
+  EXPECT_EQ(m.size(), 1000);
+  EXPECT_FALSE(m.insert(0, 0, 1).second);
+  EXPECT_TRUE(m.insert(0, 2000, 1).second);
+  EXPECT_EQ(m.count(interval_map_type::key_type(0, 2000)), 1);
+  EXPECT_EQ(m.begin()->first.first, 0);
+  EXPECT_EQ(m.rbegin()->first.first, 999);
+  EXPECT_TRUE(has_valid_queries(m));
+}
+
+TEST_F(TestIntervalMap, TestIntervalMapOverlapping) {
+  ft::interval_map<int, char> rooms;
+  rooms.insert(10, 20, 'a');
+  rooms.insert(15, 25, 'b');
+  rooms.insert(20, 30, 'c');
+  rooms.insert(40, 50, 'd');
+
+  std::vector<ft::interval_map<int, char>::iterator> found;
+  rooms.overlapping(18, 22, std::back_inserter(found));
+  ASSERT_EQ(found.size(), 3);
+  EXPECT_EQ(found[0]->second, 'a');
+  EXPECT_EQ(found[1]->second, 'b');
+  EXPECT_EQ(found[2]->second, 'c');
+
+  found.clear();
+  rooms.overlapping(30, 40, std::back_inserter(found));
+  EXPECT_TRUE(found.empty());
+
+  found.clear();
+  rooms.stabbing(20, std::back_inserter(found));
+  ASSERT_EQ(found.size(), 2);
+  EXPECT_EQ(found[0]->second, 'b');
+  EXPECT_EQ(found[1]->second, 'c');
+  found[0]->second = 'x';
+  EXPECT_EQ(rooms.find(ft::make_pair(15, 25))->second, 'x');
+}
+
+TEST_F(TestIntervalMap, TestIntervalMapErase) {
+  for (int i = 0; i < 1000; i += 3) {
+    int start = (i * 7919) % 1000;
+    ASSERT_EQ(m.erase(interval_map_type::key_type(start,
+                                                  start + (i * 31) % 50)),
+              1);
+  }
+  EXPECT_TRUE(has_valid_queries(m));
+  m.erase(m.begin(), m.find(m.begin()->first));
+  interval_map_type::iterator first = m.begin();
+  for (int i = 0; i < 100; i++)
+    ++first;
+  interval_map_type::iterator last = first;
+  for (int i = 0; i < 300; i++)
+    ++last;
+  m.erase(first, last);
+  EXPECT_EQ(m.size(), 666 - 300);
+  EXPECT_TRUE(has_valid_queries(m));
+  m.erase(m.begin());
+  EXPECT_TRUE(has_valid_queries(m));
+}
+
+TEST_F(TestIntervalMap, TestIntervalMapBatchInsert) {
+  std::vector<interval_map_type::value_type> batch;
+  for (int i = 0; i < 500; i++)
+    batch.push_back(interval_map_type::value_type(
+        interval_map_type::key_type(i * 2, i * 2 + i % 9), i));
+
+  interval_map_type built(ft::sorted_unique, batch.begin(), batch.end());
+  EXPECT_EQ(built.size(), 500);
+  EXPECT_TRUE(has_valid_queries(built));
+
+  m.insert(batch.begin(), batch.end());
+  EXPECT_TRUE(has_valid_queries(m));
+}
+
+TEST_F(TestIntervalMap, TestIntervalMapCopy) {
+  interval_map_type copy(m);
+  EXPECT_TRUE(copy == m);
+  EXPECT_TRUE(has_valid_queries(copy));
+  m.clear();
+  EXPECT_TRUE(has_valid_queries(m));
+  copy.swap(m);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(has_valid_queries(m));
+}
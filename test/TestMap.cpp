@@ -1,6 +1,61 @@
 #include <gtest/gtest.h>
 
 #include "map.hpp"
+#include "vector.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Comparator that counts its invocations
+struct CountingLess {
+  static int calls;
+  bool operator()(int lhs, int rhs) const {
+    calls++;
+    return lhs < rhs;
+  }
+};
+int CountingLess::calls = 0;
+
+// Allocator that counts the allocations made through any of its rebinds
+struct AllocationCounter {
+  static int allocations;
+};
+int AllocationCounter::allocations = 0;
+
+template <class T> struct CountingAllocator : public std::allocator<T> {
+  template <class U> struct rebind { typedef CountingAllocator<U> other; };
+
+  CountingAllocator() {}
+  template <class U> CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(std::size_t n, const void * = 0) {
+    AllocationCounter::allocations++;
+    return std::allocator<T>::allocate(n);
+  }
+};
+
+// Value that counts its live objects, and whose copies throw once
+// copies_left runs out
+struct ThrowingCopy {
+  static int live;
+  static int copies_left;
+  int value;
+
+  ThrowingCopy(int v = 0) : value(v) { live++; }
+  ThrowingCopy(const ThrowingCopy &other) : value(other.value) {
+    if (copies_left-- == 0)
+      throw std::runtime_error("copy");
+    live++;
+  }
+  ThrowingCopy &operator=(const ThrowingCopy &other) {
+    value = other.value;
+    return *this;
+  }
+  ~ThrowingCopy() { live--; }
+};
+int ThrowingCopy::live = 0;
+int ThrowingCopy::copies_left = -1;
 
 class TestMap : public ::testing::Test {
 protected:
@@ -193,6 +248,184 @@ TEST_F(TestMap, TestMapInsert) {
   ASSERT_EQ(mymap['i'], 18);
 }
 
+TEST_F(TestMap, TestMapInsertHint) {
+  ft::map<int, int> mymap;
+  for (int i = 0; i < 100; i += 2)
+    mymap.insert(mymap.end(), ft::make_pair(i, i));
+  for (int i = -2; i > -100; i -= 2)
+    mymap.insert(mymap.begin(), ft::make_pair(i, i));
+  for (int i = -97; i < 100; i += 2)
+    mymap.insert(mymap.find(i + 1), ft::make_pair(i, i));
+  ASSERT_EQ(mymap.size(), 198);
+
+  // Equivalent keys are not inserted and return the existing element
+  ft::map<int, int>::iterator it = mymap.find(42);
+  ASSERT_TRUE(mymap.insert(it, ft::make_pair(42, 0)) == it);
+  ASSERT_EQ(it->second, 42);
+
+  // Wrong hints still insert at the right position
+  ASSERT_EQ(mymap.insert(mymap.begin(), ft::make_pair(500, 500))->first, 500);
+  ASSERT_EQ(mymap.insert(mymap.end(), ft::make_pair(-500, -500))->first,
+            -500);
+  ASSERT_EQ(mymap.insert(mymap.find(0), ft::make_pair(-99, -99))->first, -99);
+  ASSERT_EQ(mymap.size(), 201);
+
+  int expected[] = {-500, -99, -98, -97};
+  it = mymap.begin();
+  for (int i = 0; i < 4; i++, it++)
+    ASSERT_EQ(it->first, expected[i]);
+  for (int i = -96; i < 100; i++, it++)
+    ASSERT_EQ(it->first, i);
+  ASSERT_EQ(it->first, 500);
+  ASSERT_EQ(--mymap.end(), it);
+}
+
+TEST_F(TestMap, TestMapInsertHintComparisons) {
+  ft::map<int, int, CountingLess> mymap;
+  CountingLess::calls = 0;
+  for (int i = 0; i < 1000; i += 2)
+    mymap.insert(mymap.end(), ft::make_pair(i, i));
+  // A single comparison against the maximum per sorted insertion
+  ASSERT_LE(CountingLess::calls, 500);
+
+  // Filling the gap right before each hint takes at most two comparisons
+  ft::map<int, int, CountingLess>::iterator hint = mymap.begin();
+  CountingLess::calls = 0;
+  for (int i = 1; i < 1000; i += 2) {
+    ++hint;
+    mymap.insert(hint, ft::make_pair(i, i));
+  }
+  ASSERT_LE(CountingLess::calls, 1000);
+  ASSERT_EQ(mymap.size(), 1000);
+
+  int expected = 0;
+  for (hint = mymap.begin(); hint != mymap.end(); ++hint)
+    ASSERT_EQ(hint->first, expected++);
+}
+
+TEST_F(TestMap, TestMapLookupComparisons) {
+  const int n = 1000;
+  ft::map<int, int, CountingLess> mymap;
+  for (int i = 0; i < n; i++)
+    mymap[(i * 7919) % n * 2] = i;
+  // A red-black tree of n nodes is at most 2 * log2(n + 1) levels deep, and
+  // each lookup takes one comparison per level plus an equivalence check
+  const int max_calls = 2 * 10 + 1;
+  for (int key = -1; key < 2 * n; key++) {
+    CountingLess::calls = 0;
+    ft::map<int, int, CountingLess>::iterator it = mymap.find(key);
+    ASSERT_LE(CountingLess::calls, max_calls);
+    ASSERT_EQ(it != mymap.end(), key >= 0 && key % 2 == 0);
+
+    CountingLess::calls = 0;
+    ASSERT_EQ(mymap.count(key), it != mymap.end() ? 1u : 0u);
+    ASSERT_LE(CountingLess::calls, max_calls);
+
+    CountingLess::calls = 0;
+    ft::pair<ft::map<int, int, CountingLess>::iterator,
+             ft::map<int, int, CountingLess>::iterator>
+        range = mymap.equal_range(key);
+    ASSERT_LE(CountingLess::calls, max_calls);
+    ASSERT_TRUE(range.first == mymap.lower_bound(key));
+    ASSERT_TRUE(range.second == mymap.upper_bound(key));
+  }
+
+  // Unhinted insertions descend the same way, present keys or not
+  for (int key = -1; key < 2 * n; key++) {
+    CountingLess::calls = 0;
+    ASSERT_EQ(mymap.insert(ft::make_pair(key, 0)).second,
+              key < 0 || key % 2 == 1);
+    ASSERT_LE(CountingLess::calls, max_calls);
+    if (key < 0 || key % 2 == 1)
+      mymap.erase(key);
+  }
+}
+
+TEST_F(TestMap, TestMapSwapDoesNotAllocate) {
+  typedef ft::map<int, int, ft::less<int>,
+                  CountingAllocator<ft::pair<const int, int>>>
+      counted_map;
+  counted_map large;
+  counted_map small;
+  for (int i = 0; i < 1000; i++)
+    large[i] = i;
+  small[-1] = -1;
+  counted_map::iterator it = large.find(500);
+
+  AllocationCounter::allocations = 0;
+  large.swap(small);
+  ft::swap(large, small);
+  large.swap(small);
+  ASSERT_EQ(AllocationCounter::allocations, 0);
+
+  ASSERT_EQ(large.size(), 1);
+  ASSERT_EQ(small.size(), 1000);
+  ASSERT_TRUE(small.find(500) == it);
+  ASSERT_EQ(large.begin()->first, -1);
+  ASSERT_EQ((--small.end())->first, 999);
+
+  // Each map keeps allocating from and recycling into the pool it took over
+  small.erase(it);
+  small[1000] = 1000;
+  large[0] = 0;
+  ASSERT_EQ(small.size(), 1000);
+  ASSERT_EQ(large.size(), 2);
+}
+
+TEST_F(TestMap, TestMapSortedUnique) {
+  ft::vector<ft::pair<int, int>> sorted;
+  for (int i = 0; i < 100; i++)
+    sorted.push_back(ft::make_pair(i * 2, i));
+  CountingLess::calls = 0;
+  ft::map<int, int, CountingLess> mymap(ft::sorted_unique, sorted.begin(),
+                                        sorted.end());
+  // Building from a sorted range compares no keys
+  ASSERT_EQ(CountingLess::calls, 0);
+  ASSERT_EQ(mymap.size(), 100);
+  ASSERT_EQ(mymap.begin()->first, 0);
+  ASSERT_EQ(mymap.rbegin()->first, 198);
+  ASSERT_EQ(mymap[42], 21);
+
+  // A non-empty map falls back to regular insertion
+  ft::pair<int, int> odd[] = {ft::make_pair(1, -1), ft::make_pair(42, -1),
+                              ft::make_pair(301, -1)};
+  mymap.insert(ft::sorted_unique, odd, odd + 3);
+  ASSERT_EQ(mymap.size(), 102);
+  ASSERT_EQ(mymap[42], 21);
+  ASSERT_EQ(mymap[1], -1);
+  ASSERT_EQ(mymap.rbegin()->first, 301);
+
+  ft::map<int, int, CountingLess> empty;
+  empty.insert(ft::sorted_unique, sorted.begin(), sorted.end());
+  ft::map<int, int, CountingLess> expected(sorted.begin(), sorted.end());
+  ASSERT_TRUE(empty == expected);
+}
+
+TEST_F(TestMap, TestMapSortedUniqueThrowingCopy) {
+  typedef ft::map<int, ThrowingCopy> throwing_map;
+  ft::vector<ft::pair<int, ThrowingCopy>> sorted;
+  for (int i = 0; i < 100; i++)
+    sorted.push_back(ft::make_pair(i, ThrowingCopy(i)));
+  const int live = ThrowingCopy::live;
+
+  // The values copied before the throw are destroyed with their nodes
+  ThrowingCopy::copies_left = 60;
+  EXPECT_THROW(throwing_map(ft::sorted_unique, sorted.begin(), sorted.end()),
+               std::runtime_error);
+  EXPECT_EQ(ThrowingCopy::live, live);
+
+  throwing_map m;
+  ThrowingCopy::copies_left = 99;
+  EXPECT_THROW(m.insert(ft::sorted_unique, sorted.begin(), sorted.end()),
+               std::runtime_error);
+  EXPECT_EQ(ThrowingCopy::live, live);
+  EXPECT_TRUE(m.empty());
+  ThrowingCopy::copies_left = -1;
+  m.insert(ft::sorted_unique, sorted.begin(), sorted.end());
+  EXPECT_EQ(m.size(), 100);
+  EXPECT_EQ(m.rbegin()->second.value, 99);
+}
+
 TEST_F(TestMap, TestMapErase) {
   ft::map<char, int> mymap;
   mymap['a'] = 2;
@@ -549,3 +782,321 @@ TEST_F(TestMap, TestMapSwapOperator) {
   ASSERT_TRUE(mymap1 == mymap2);
   ASSERT_TRUE(mymap2 == mymap1);
 }
+
+// Mapped type that counts how it was constructed
+struct Constructed {
+  static int constructions; // from arguments
+  static int copies;
+  int a;
+  int b;
+
+  Constructed() : a(0), b(0) { constructions++; }
+  Constructed(int a, int b) : a(a), b(b) { constructions++; }
+  Constructed(const Constructed &other) : a(other.a), b(other.b) { copies++; }
+
+  static void reset() { constructions = copies = 0; }
+};
+int Constructed::constructions = 0;
+int Constructed::copies = 0;
+
+TEST_F(TestMap, TestMapTryEmplace) {
+  ft::map<int, Constructed> m;
+  Constructed::reset();
+  ft::pair<ft::map<int, Constructed>::iterator, bool> res =
+      m.try_emplace(1, 2, 3);
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(res.first->second.b, 3);
+  ASSERT_EQ(Constructed::constructions, 1);
+  ASSERT_EQ(Constructed::copies, 0);
+
+  // An existing key constructs nothing and keeps its value
+  res = m.try_emplace(1, 5, 5);
+  ASSERT_FALSE(res.second);
+  ASSERT_EQ(res.first->second.a, 2);
+  ASSERT_EQ(Constructed::constructions, 1);
+
+  m[2].a = 7;
+  ASSERT_EQ(m[2].a, 7);
+  ASSERT_EQ(m[1].a, 2);
+  ASSERT_EQ(Constructed::constructions, 2);
+  ASSERT_EQ(Constructed::copies, 0);
+  ASSERT_EQ(m.size(), 2);
+
+  for (int i = 10; i > 2; i--)
+    m.try_emplace(i);
+  ASSERT_EQ(m.size(), 10);
+  int key = 1;
+  for (ft::map<int, Constructed>::iterator it = m.begin(); it != m.end(); ++it)
+    ASSERT_EQ(it->first, key++);
+}
+
+TEST_F(TestMap, TestMapEmplace) {
+  ft::map<int, std::string> m;
+  ft::pair<ft::map<int, std::string>::iterator, bool> res =
+      m.emplace(1, "one");
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(res.first->second, "one");
+  res = m.emplace(ft::make_pair(1, std::string("uno")));
+  ASSERT_FALSE(res.second);
+  ASSERT_EQ(res.first->second, "one");
+
+  ft::map<int, std::string>::iterator it = m.emplace_hint(m.end(), 3, "three");
+  ASSERT_EQ(it->first, 3);
+  it = m.emplace_hint(it, 2, "two");
+  ASSERT_EQ(it->first, 2);
+  it = m.emplace_hint(m.begin(), 3, "tres");
+  ASSERT_EQ(it->second, "three");
+  ASSERT_EQ(m.size(), 3);
+  ASSERT_EQ(m.begin()->second, "one");
+  ASSERT_EQ((--m.end())->second, "three");
+}
+
+TEST_F(TestMap, TestMapExtractRange) {
+  ft::map<int, Constructed> m;
+  for (int i = 0; i < 100; i++)
+    m.try_emplace(i, i, -i);
+  Constructed::reset();
+  ft::map<int, Constructed> range =
+      m.extract_range(m.lower_bound(20), m.lower_bound(90));
+  EXPECT_EQ(Constructed::copies, 0);
+  EXPECT_EQ(range.size(), 70);
+  EXPECT_EQ(m.size(), 30);
+  EXPECT_EQ(range.begin()->first, 20);
+  EXPECT_EQ(range.rbegin()->first, 89);
+  EXPECT_EQ(range[50].b, -50);
+  EXPECT_TRUE(m.find(50) == m.end());
+  EXPECT_EQ((--m.lower_bound(90))->first, 19);
+
+  ft::map<int, Constructed> tail = m.extract_range(m.begin(), m.end());
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(tail.size(), 30);
+  m.try_emplace(1);
+  EXPECT_EQ(m.size(), 1);
+}
+
+TEST_F(TestMap, TestMapSplice) {
+  ft::map<int, Constructed> low;
+  ft::map<int, Constructed> high;
+  for (int i = 0; i < 50; i++) {
+    low.try_emplace(i, i, 0);
+    high.try_emplace(i + 50, i + 50, 0);
+  }
+  Constructed::reset();
+  high.splice(low);
+  EXPECT_EQ(Constructed::copies, 0);
+  EXPECT_TRUE(low.empty());
+  EXPECT_EQ(high.size(), 100);
+  int key = 0;
+  for (ft::map<int, Constructed>::iterator it = high.begin();
+       it != high.end(); ++it)
+    ASSERT_EQ(it->second.a, key++);
+
+  ft::map<int, Constructed> overlap;
+  overlap.try_emplace(10, -1, 0);
+  overlap.try_emplace(100, 100, 0);
+  high.splice(overlap);
+  EXPECT_EQ(Constructed::copies, 0);
+  EXPECT_EQ(high.size(), 101);
+  EXPECT_EQ(high[10].a, 10);
+  EXPECT_EQ(overlap.size(), 1);
+  EXPECT_EQ(overlap[10].a, -1);
+
+  // The spliced nodes outlive the map they came from
+  ft::map<int, Constructed> *source = new ft::map<int, Constructed>;
+  (*source)[200].a = 200;
+  high.splice(*source);
+  delete source;
+  EXPECT_EQ(high[200].a, 200);
+  high.erase(200);
+  high[201].a = 201;
+  EXPECT_EQ(high.size(), 102);
+}
+
+TEST_F(TestMap, TestMapOrderStatistics) {
+  typedef ft::map<int, int, ft::less<int>,
+                  std::allocator<ft::pair<const int, int>>,
+                  ft::rb_order_statistic_policy>
+      ranked_map;
+  ranked_map m;
+  for (int i = 0; i < 100; i++)
+    m[i * 10] = i;
+  EXPECT_EQ(m.rank(0), 0);
+  EXPECT_EQ(m.rank(55), 6);
+  EXPECT_EQ(m.rank(1000), 100);
+  EXPECT_EQ(m.nth(42)->second, 42);
+  EXPECT_TRUE(m.nth(100) == m.end());
+  EXPECT_EQ(m.distance(m.find(100), m.find(300)), 20);
+  const ranked_map &view = m;
+  EXPECT_EQ(view.nth(7)->first, 70);
+  EXPECT_EQ(view.distance(view.begin(), view.end()), 100);
+}
+
+#if FT_HAS_MOVE
+TEST_F(TestMap, TestMapMove) {
+  ft::map<int, std::string> m;
+  for (int i = 0; i < 10; i++)
+    m[i] = std::string(32, 'a' + i);
+  ft::map<int, std::string>::iterator it = m.find(5);
+  ft::map<int, std::string> moved(std::move(m));
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(moved.size(), 10);
+  EXPECT_TRUE(it == moved.find(5));
+
+  ft::map<int, std::string> assigned;
+  assigned[42] = "gone";
+  assigned = std::move(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(assigned.count(42), 0);
+  EXPECT_EQ(it->second, std::string(32, 'f'));
+  m[1] = "reused";
+  EXPECT_EQ(m.size(), 1);
+
+  // The mapped value is only moved from when it is inserted
+  ft::pair<const int, std::string> fresh(100, std::string(32, 'z'));
+  EXPECT_TRUE(assigned.insert(std::move(fresh)).second);
+  EXPECT_TRUE(fresh.second.empty());
+  ft::pair<const int, std::string> taken(100, std::string(32, 'y'));
+  EXPECT_FALSE(assigned.insert(assigned.end(), std::move(taken)) ==
+               assigned.end());
+  EXPECT_EQ(taken.second, std::string(32, 'y'));
+  EXPECT_EQ(assigned[100], std::string(32, 'z'));
+}
+
+TEST_F(TestMap, TestMapNothrowMove) {
+  typedef ft::map<int, std::string> string_map;
+  EXPECT_TRUE(std::is_nothrow_move_constructible<string_map>::value);
+  EXPECT_TRUE(
+      (std::is_nothrow_move_constructible<ft::multimap<int, int>>::value));
+
+  // Growing a vector of maps moves them, so their nodes stay in place
+  ft::vector<string_map> maps(1);
+  maps[0][7] = "seven";
+  const ft::pair<const int, std::string> *node = &*maps[0].begin();
+  maps.reserve(maps.capacity() * 4);
+  EXPECT_EQ(&*maps[0].begin(), node);
+
+  // A moved-from map stays usable through every way of filling it
+  string_map from;
+  from[1] = "one";
+  string_map to(std::move(from));
+  EXPECT_TRUE(from.empty());
+  EXPECT_TRUE(from.begin() == from.end());
+  EXPECT_TRUE(from.find(1) == from.end());
+  EXPECT_EQ(from.erase(1), 0);
+  from.clear();
+  from.insert(from.end(), ft::make_pair(2, std::string("two")));
+  EXPECT_EQ(from.begin()->second, "two");
+
+  string_map hollow(std::move(to));
+  hollow = from;
+  EXPECT_EQ(hollow.size(), 1);
+  string_map sorted(std::move(hollow));
+  ft::pair<int, std::string> values[] = {ft::make_pair(3, "c"),
+                                         ft::make_pair(4, "d")};
+  hollow.insert(ft::sorted_unique, values, values + 2);
+  EXPECT_EQ(hollow.rbegin()->first, 4);
+  EXPECT_EQ(to.insert(ft::make_pair(5, "e")).first->first, 5);
+}
+#endif
+
+TEST_F(TestMap, TestMapAggregate) {
+  typedef ft::map<long, double, ft::less<long>,
+                  std::allocator<ft::pair<const long, double>>,
+                  ft::rb_aggregate_policy<ft::sum_monoid<double>>>
+      volume_map;
+  volume_map volume;
+  for (long t = 0; t < 1000; t++)
+    volume.insert_or_assign(t * 10, 0.5 * (t % 4));
+  EXPECT_DOUBLE_EQ(volume.aggregate(0, 9990), 750.0);
+  EXPECT_DOUBLE_EQ(volume.aggregate(5, 35), 3.0);
+  EXPECT_DOUBLE_EQ(volume.aggregate(10, 10), 0.5);
+  EXPECT_DOUBLE_EQ(volume.aggregate(11, 19), 0.0);
+  EXPECT_DOUBLE_EQ(volume.aggregate(30, 10), 0.0);
+  EXPECT_FALSE(volume.insert_or_assign(20, 100.0).second);
+  volume.erase(30);
+  EXPECT_DOUBLE_EQ(volume.aggregate(5, 35), 100.5);
+  volume.insert_or_assign(10, volume.find(10)->second + 2.0);
+  volume.insert_or_assign(volume.begin()->first, 4.0);
+  EXPECT_DOUBLE_EQ(volume.aggregate(0, 35), 106.5);
+  EXPECT_DOUBLE_EQ(volume.aggregate(0, 9990), 853.5);
+
+  typedef ft::map<long, double, ft::less<long>,
+                  std::allocator<ft::pair<const long, double>>,
+                  ft::rb_aggregate_policy<ft::max_monoid<double>>>
+      peak_map;
+  peak_map peak(volume.begin(), volume.end());
+  EXPECT_DOUBLE_EQ(peak.aggregate(0, 9990), 100.0);
+  EXPECT_DOUBLE_EQ(peak.aggregate(40, 60), 1.0);
+  EXPECT_EQ(peak.aggregate(-5, -1), -std::numeric_limits<double>::max());
+}
+
+TEST_F(TestMap, TestMapAggregateSeesEveryWrite) {
+  typedef ft::map<int, long, ft::less<int>,
+                  std::allocator<ft::pair<const int, long>>,
+                  ft::rb_aggregate_policy<ft::sum_monoid<long>>>
+      sum_map;
+  sum_map m;
+  for (int i = 0; i < 100; i++)
+    m.insert_or_assign((i * 37) % 100, 0);
+  for (int i = 0; i < 100; i++)
+    m.insert_or_assign((i * 37) % 100, (i * 37) % 100);
+  EXPECT_EQ(m.aggregate(0, 99), 4950);
+
+  // Writes that would bypass the summaries do not compile: operator[] is
+  // rejected and the iterators are read-only
+  typedef ft::iterator_traits<sum_map::iterator>::reference reference;
+  EXPECT_TRUE((std::is_same<reference, const sum_map::value_type &>::value));
+}
+
+TEST(TestMultimap, TestMultimapDuplicateKeys) {
+  ft::multimap<int, char> m;
+  m.insert(ft::make_pair(2, 'a'));
+  m.insert(ft::make_pair(1, 'b'));
+  m.insert(ft::make_pair(2, 'c'));
+  m.emplace(2, 'd');
+  m.insert(m.find(2), ft::make_pair(2, 'e'));
+  ASSERT_EQ(m.size(), 5);
+  EXPECT_EQ(m.count(2), 4);
+  EXPECT_EQ(m.count(3), 0);
+
+  // Equal keys keep their insertion order, but for the hinted insert
+  const char expected[] = {'b', 'e', 'a', 'c', 'd'};
+  int i = 0;
+  for (ft::multimap<int, char>::iterator it = m.begin(); it != m.end(); ++it)
+    EXPECT_EQ(it->second, expected[i++]);
+
+  ft::pair<ft::multimap<int, char>::iterator,
+           ft::multimap<int, char>::iterator>
+      range = m.equal_range(2);
+  EXPECT_EQ(ft::distance(range.first, range.second), 4);
+  EXPECT_EQ(range.first->second, 'e');
+  EXPECT_TRUE(range.second == m.end());
+
+  EXPECT_EQ(m.erase(2), 4);
+  EXPECT_EQ(m.size(), 1);
+  EXPECT_EQ(m.begin()->second, 'b');
+}
+
+TEST(TestMultimap, TestMultimapCopyAndSplice) {
+  ft::multimap<int, int> m;
+  for (int i = 0; i < 100; i++)
+    m.insert(ft::make_pair(i % 10, i));
+  ft::multimap<int, int> copy(m);
+  EXPECT_TRUE(copy == m);
+  ft::multimap<int, int> tail = m.extract_range(m.lower_bound(5), m.end());
+  EXPECT_EQ(m.size(), 50);
+  EXPECT_EQ(tail.count(7), 10);
+  EXPECT_TRUE(m < copy);
+  m.splice(tail);
+  EXPECT_TRUE(tail.empty());
+  EXPECT_TRUE(m == copy);
+  m.splice(copy);
+  EXPECT_EQ(m.size(), 200);
+  EXPECT_EQ(m.count(3), 20);
+  // Spliced elements go after the equal keys already present
+  ft::multimap<int, int>::iterator it = m.lower_bound(3);
+  for (int i = 0; i < 10; i++, ++it)
+    EXPECT_EQ(it->second, i * 10 + 3);
+  for (int i = 0; i < 10; i++, ++it)
+    EXPECT_EQ(it->second, i * 10 + 3);
+}
@@ -2,6 +2,7 @@
 #include <map>
 #include <set>
 #include <stack>
+#include <stdint.h>
 #include <vector>
 
 const int kNumIterations = 100000;
@@ -21,6 +22,31 @@ TEST(TestPerformanceSTL, TestVectorErase) {
   v.erase(v.begin(), v.end());
 }
 
+struct PodRecord {
+  uint64_t id;
+  uint64_t timestamp;
+  double value;
+};
+
+TEST(TestPerformanceSTL, TestVectorInsertFront) {
+  std::vector<uint64_t> v;
+  for (int i = 0; i < kNumIterations / 10; i++)
+    v.insert(v.begin(), i);
+  for (int i = 0; i < kNumIterations / 10; i++)
+    v.erase(v.begin());
+}
+
+TEST(TestPerformanceSTL, TestVectorPodInsertErase) {
+  std::vector<PodRecord> v;
+  PodRecord record = {0, 0, 0.0};
+  for (int i = 0; i < kNumIterations / 10; i++) {
+    record.id = i;
+    v.insert(v.begin() + v.size() / 2, record);
+  }
+  while (!v.empty())
+    v.erase(v.begin(), v.begin() + (v.size() + 1) / 2);
+}
+
 TEST(TestPerformanceSTL, TestMap) {
   std::map<int, int> m;
   for (int i = 0; i < kNumIterations; i++)
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+#include "map.hpp"
+#include "pool_allocator.hpp"
+#include "set.hpp"
+
+// Upstream allocator that tracks outstanding memory
+struct UpstreamStats {
+  static long allocations;
+  static long outstanding;
+};
+long UpstreamStats::allocations = 0;
+long UpstreamStats::outstanding = 0;
+
+template <class T> struct TrackingAllocator : public std::allocator<T> {
+  template <class U> struct rebind { typedef TrackingAllocator<U> other; };
+
+  TrackingAllocator() {}
+  template <class U> TrackingAllocator(const TrackingAllocator<U> &) {}
+
+  T *allocate(std::size_t n, const void * = 0) {
+    UpstreamStats::allocations++;
+    UpstreamStats::outstanding += n * sizeof(T);
+    return std::allocator<T>::allocate(n);
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    UpstreamStats::outstanding -= n * sizeof(T);
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
+struct Block {
+  void *a;
+  void *b;
+  int c;
+};
+
+class TestPoolAllocator : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    UpstreamStats::allocations = 0;
+    UpstreamStats::outstanding = 0;
+  }
+};
+
+TEST_F(TestPoolAllocator, TestAllocateFromSlab) {
+  ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+  Block *first = pool.allocate(1);
+  Block *second = pool.allocate(1);
+  EXPECT_EQ(second, first + 1);
+  EXPECT_EQ(UpstreamStats::allocations, 1);
+  pool.deallocate(second, 1);
+  pool.deallocate(first, 1);
+}
+
+TEST_F(TestPoolAllocator, TestRecycle) {
+  ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+  Block *blocks[100];
+  for (int i = 0; i < 100; i++)
+    blocks[i] = pool.allocate(1);
+  long allocations = UpstreamStats::allocations;
+  for (int i = 0; i < 100; i++)
+    pool.deallocate(blocks[i], 1);
+  // Freed blocks are handed out again, most recently freed first
+  EXPECT_EQ(pool.allocate(1), blocks[99]);
+  EXPECT_EQ(pool.allocate(1), blocks[98]);
+  for (int i = 0; i < 98; i++)
+    pool.allocate(1);
+  EXPECT_EQ(UpstreamStats::allocations, allocations);
+}
+
+TEST_F(TestPoolAllocator, TestRelease) {
+  {
+    ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+    for (int i = 0; i < 1000; i++)
+      pool.allocate(1);
+    EXPECT_GE(UpstreamStats::outstanding, long(1000 * sizeof(Block)));
+    pool.release();
+    EXPECT_EQ(UpstreamStats::outstanding, 0);
+    pool.allocate(1);
+    EXPECT_GT(UpstreamStats::outstanding, 0);
+  }
+  EXPECT_EQ(UpstreamStats::outstanding, 0);
+}
+
+TEST_F(TestPoolAllocator, TestArrayBypassesPool) {
+  ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+  Block *array = pool.allocate(10);
+  EXPECT_EQ(UpstreamStats::outstanding, long(10 * sizeof(Block)));
+  pool.deallocate(array, 10);
+  EXPECT_EQ(UpstreamStats::outstanding, 0);
+}
+
+TEST_F(TestPoolAllocator, TestCopyStartsEmpty) {
+  ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+  pool.allocate(1);
+  long outstanding = UpstreamStats::outstanding;
+  ft::pool_allocator<Block, TrackingAllocator<Block>> copy(pool);
+  EXPECT_EQ(UpstreamStats::outstanding, outstanding);
+  EXPECT_TRUE(pool != copy);
+}
+
+TEST_F(TestPoolAllocator, TestReserve) {
+  ft::pool_allocator<Block, TrackingAllocator<Block>> pool;
+  pool.allocate(1);
+  pool.reserve(10000);
+  EXPECT_EQ(UpstreamStats::allocations, 2);
+  Block *first = pool.allocate(1);
+  for (int i = 1; i < 10000; i++)
+    EXPECT_EQ(pool.allocate(1), first + i);
+  EXPECT_EQ(UpstreamStats::allocations, 2);
+  pool.release();
+  EXPECT_EQ(UpstreamStats::outstanding, 0);
+}
+
+TEST_F(TestPoolAllocator, TestMapCopyIsContiguous) {
+  typedef ft::pair<const int, int> value_type;
+  typedef ft::map<int, int, ft::less<int>, TrackingAllocator<value_type>>
+      map_type;
+  map_type m;
+  for (int i = 0; i < 1000; i++)
+    m[(i * 7919) % 1000] = i;
+  long allocations = UpstreamStats::allocations;
+  map_type copy(m);
+  EXPECT_LE(UpstreamStats::allocations - allocations, 2);
+  const value_type *previous = &*copy.begin();
+  for (map_type::iterator it = ++copy.begin(); it != copy.end(); ++it) {
+    EXPECT_GT(&*it, previous);
+    previous = &*it;
+  }
+}
+
+TEST_F(TestPoolAllocator, TestShare) {
+  typedef ft::pool_allocator<Block, TrackingAllocator<Block>> pool_type;
+  pool_type *first = new pool_type;
+  pool_type *second = new pool_type;
+  pool_type third;
+  Block *a = first->allocate(1);
+  Block *b = second->allocate(1);
+  first->share(*second);
+  third.share(*second);
+  long outstanding = UpstreamStats::outstanding;
+  first->deallocate(b, 1);
+  second->deallocate(a, 1);
+  delete first;
+  delete second;
+  EXPECT_EQ(UpstreamStats::outstanding, outstanding);
+  third.allocate(1);
+  third.release();
+  EXPECT_EQ(UpstreamStats::outstanding, 0);
+}
+
+TEST_F(TestPoolAllocator, TestMapRecyclesNodes) {
+  typedef ft::pair<const int, int> value_type;
+  ft::map<int, int, ft::less<int>, TrackingAllocator<value_type>> m;
+  m[-1] = -1; // keeps the last erase from clearing the whole map
+  for (int i = 0; i < 1000; i++)
+    m[i] = i;
+  long allocations = UpstreamStats::allocations;
+  for (int i = 0; i < 1000; i++)
+    m.erase(i);
+  for (int i = 1000; i < 2000; i++)
+    m[i] = i;
+  EXPECT_EQ(UpstreamStats::allocations, allocations);
+}
+
+TEST_F(TestPoolAllocator, TestSetClearReleasesSlabs) {
+  ft::set<int, ft::less<int>, TrackingAllocator<int>> s;
+  long sentinel = UpstreamStats::outstanding;
+  for (int i = 0; i < 1000; i++)
+    s.insert(i);
+  EXPECT_GT(UpstreamStats::outstanding, sentinel);
+  s.clear();
+  EXPECT_EQ(UpstreamStats::outstanding, sentinel);
+  s.insert(1);
+  EXPECT_EQ(*s.begin(), 1);
+}
+
+typedef ft::map<int, int, ft::less<int>,
+                TrackingAllocator<ft::pair<const int, int>>>
+    tracked_map;
+
+TEST_F(TestPoolAllocator, TestMapExtractRangeReusesNodes) {
+  tracked_map m;
+  for (int i = 0; i < 1000; i++)
+    m[i] = i;
+  long outstanding = 0;
+  for (int cycle = 0; cycle < 2000; cycle++) {
+    // The nodes freed with the extracted range go back to m
+    { tracked_map range = m.extract_range(m.find(100), m.find(600)); }
+    for (int i = 100; i < 600; i++)
+      m[i] = i;
+    if (cycle == 10)
+      outstanding = UpstreamStats::outstanding;
+  }
+  EXPECT_EQ(UpstreamStats::outstanding, outstanding);
+  EXPECT_EQ(m.size(), 1000);
+}
+
+TEST_F(TestPoolAllocator, TestMapSpliceReusesNodes) {
+  tracked_map m;
+  for (int i = 0; i < 1000; i++)
+    m[i] = i;
+  long outstanding = 0;
+  for (int cycle = 0; cycle < 2000; cycle++) {
+    {
+      // The nodes freed in the range go back to m with the rest
+      tracked_map range = m.extract_range(m.find(500), m.end());
+      range.erase(range.find(600), range.find(700));
+      m.splice(range);
+    }
+    for (int i = 600; i < 700; i++)
+      m[i] = i;
+    if (cycle == 10)
+      outstanding = UpstreamStats::outstanding;
+  }
+  EXPECT_EQ(UpstreamStats::outstanding, outstanding);
+  EXPECT_EQ(m.size(), 1000);
+}
+
+// Maps sharing an arena may each be used from their own thread
+static void churn(ft::map<int, int> &m, int first, int last) {
+  for (int round = 0; round < 20; round++) {
+    {
+      ft::map<int, int> range =
+          m.extract_range(m.lower_bound(first), m.lower_bound(last));
+    }
+    for (int i = first; i < last; i++)
+      m[i] = round;
+  }
+}
+
+TEST_F(TestPoolAllocator, TestSharedArenaAcrossThreads) {
+  const int n = 20000;
+  ft::map<int, int> m;
+  for (int i = 0; i < n; i++)
+    m[i] = -1;
+  ft::map<int, int> shard = m.extract_range(m.lower_bound(n / 2), m.end());
+  std::thread worker(churn, std::ref(shard), n / 2, n);
+  churn(m, 0, n / 2);
+  worker.join();
+  m.splice(shard);
+  ASSERT_EQ(m.size(), n);
+  int key = 0;
+  for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); ++it) {
+    ASSERT_EQ(it->first, key++);
+    ASSERT_EQ(it->second, 19);
+  }
+}
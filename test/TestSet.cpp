@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "set.hpp"
+#include <string>
 
 TEST(TestSet, TestSetDefaultConstructor) {
   ft::set<int> s;
@@ -132,6 +133,24 @@ TEST(TestSet, TestSetInsert) {
   ASSERT_EQ(s.count(4), 1);
 }
 
+TEST(TestSet, TestSetInsertHint) {
+  ft::set<int> s;
+  for (int i = 0; i < 50; i++)
+    s.insert(s.end(), i);
+  for (int i = -1; i > -50; i--)
+    s.insert(s.begin(), i);
+  s.insert(s.find(10), 100);
+  s.insert(s.find(10), -100);
+  ASSERT_EQ(s.size(), 101);
+
+  ft::set<int>::iterator it = s.begin();
+  ASSERT_EQ(*it++, -100);
+  for (int i = -49; i < 50; i++)
+    ASSERT_EQ(*it++, i);
+  ASSERT_EQ(*it++, 100);
+  ASSERT_TRUE(it == s.end());
+}
+
 TEST(TestSet, TestSetErase) {
   int arr[] = {1, 2, 3, 4, 5};
   ft::set<int> s(arr, arr + 5);
@@ -345,3 +364,140 @@ TEST(TestSet, TestSetSwapOverload) {
   ASSERT_EQ(*it++, 2);
   ASSERT_EQ(*it, 3);
 }
+
+TEST(TestSet, TestSetCompactPolicy) {
+  typedef ft::set<unsigned long, ft::less<unsigned long>,
+                  std::allocator<unsigned long>, ft::rb_compact_policy>
+      compact_set;
+  compact_set s;
+  for (unsigned long i = 0; i < 100; i++)
+    s.insert((i * 37) % 100);
+  ASSERT_EQ(s.size(), 100);
+  ASSERT_EQ(*s.begin(), 0);
+  ASSERT_EQ(*s.rbegin(), 99);
+  ASSERT_EQ(s.count(42), 1);
+  s.erase(42);
+  ASSERT_EQ(s.count(42), 0);
+  ASSERT_EQ(*s.lower_bound(42), 43);
+
+  compact_set s2(s);
+  ASSERT_TRUE(s == s2);
+}
+
+TEST(TestSet, TestSetSortedUnique) {
+  int sorted[] = {1, 3, 5, 7, 9, 11, 13};
+  ft::set<int> s(ft::sorted_unique, sorted, sorted + 7);
+  ASSERT_EQ(s.size(), 7);
+  ASSERT_EQ(*s.begin(), 1);
+  ASSERT_EQ(*s.rbegin(), 13);
+  ASSERT_EQ(*s.lower_bound(6), 7);
+
+  s.insert(ft::sorted_unique, sorted, sorted + 7);
+  ASSERT_EQ(s.size(), 7);
+  s.insert(4);
+  ASSERT_EQ(*s.upper_bound(3), 4);
+}
+
+TEST(TestSet, TestSetEqualRangeUnique) {
+  ft::set<int> s;
+  for (int i = 0; i < 100; i += 2)
+    s.insert(i);
+  for (int i = -1; i <= 100; i++) {
+    ft::pair<ft::set<int>::iterator, ft::set<int>::iterator> range =
+        s.equal_range(i);
+    ASSERT_TRUE(range.first == s.lower_bound(i));
+    ASSERT_TRUE(range.second == s.upper_bound(i));
+    ASSERT_EQ(s.count(i), i >= 0 && i < 100 && i % 2 == 0 ? 1u : 0u);
+  }
+}
+
+TEST(TestSet, TestSetEmplace) {
+  ft::set<std::string> s;
+  ft::pair<ft::set<std::string>::iterator, bool> res = s.emplace(3, 'b');
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(*res.first, "bbb");
+  res = s.emplace("bbb");
+  ASSERT_FALSE(res.second);
+  ASSERT_EQ(s.size(), 1);
+
+  ft::set<std::string>::iterator it = s.emplace_hint(s.end(), 2, 'c');
+  ASSERT_EQ(*it, "cc");
+  it = s.emplace_hint(s.begin(), std::string("xaz"), 1, 1);
+  ASSERT_EQ(*it, "a");
+  s.emplace();
+  ASSERT_EQ(s.size(), 4);
+  ASSERT_EQ(*s.begin(), "");
+  ASSERT_EQ(*(--s.end()), "cc");
+}
+
+TEST(TestSet, TestSetExtractRangeAndSplice) {
+  ft::set<int> s;
+  for (int i = 0; i < 100; i++)
+    s.insert(i);
+  ft::set<int> high = s.extract_range(s.find(60), s.end());
+  EXPECT_EQ(s.size(), 60);
+  EXPECT_EQ(high.size(), 40);
+  EXPECT_EQ(*s.rbegin(), 59);
+  EXPECT_EQ(*high.begin(), 60);
+  s.splice(high);
+  EXPECT_TRUE(high.empty());
+  EXPECT_EQ(s.size(), 100);
+  int expected = 0;
+  for (ft::set<int>::iterator it = s.begin(); it != s.end(); ++it)
+    ASSERT_EQ(*it, expected++);
+}
+
+TEST(TestSet, TestSetOrderStatistics) {
+  ft::set<int, ft::less<int>, std::allocator<int>,
+          ft::rb_order_statistic_policy>
+      latencies;
+  for (int i = 0; i < 1000; i++)
+    latencies.insert((i * 7919) % 1000);
+  EXPECT_EQ(*latencies.nth(500), 500);
+  EXPECT_EQ(*latencies.nth(990), 990);
+  EXPECT_EQ(latencies.rank(250), 250);
+  latencies.erase(latencies.begin(), latencies.find(500));
+  EXPECT_EQ(*latencies.nth(0), 500);
+  EXPECT_EQ(latencies.rank(750), 250);
+  EXPECT_EQ(latencies.distance(latencies.find(600), latencies.end()), 400);
+  EXPECT_TRUE(latencies.nth(500) == latencies.end());
+}
+
+TEST(TestSet, TestSetAggregate) {
+  ft::set<int, ft::less<int>, std::allocator<int>,
+          ft::rb_aggregate_policy<ft::min_monoid<int>>>
+      s;
+  for (int i = 0; i < 100; i++)
+    s.insert((i * 37) % 100);
+  EXPECT_EQ(s.aggregate(10, 20), 10);
+  s.erase(10);
+  EXPECT_EQ(s.aggregate(10, 20), 11);
+  EXPECT_EQ(s.aggregate(200, 300), std::numeric_limits<int>::max());
+}
+
+TEST(TestMultiset, TestMultisetDuplicateValues) {
+  int arr[] = {3, 1, 3, 2, 3, 1};
+  ft::multiset<int> s(arr, arr + 6);
+  ASSERT_EQ(s.size(), 6);
+  EXPECT_EQ(s.count(3), 3);
+  EXPECT_EQ(s.count(1), 2);
+  EXPECT_EQ(s.count(4), 0);
+  EXPECT_EQ(*s.insert(2), 2);
+  EXPECT_EQ(s.count(2), 2);
+
+  const int expected[] = {1, 1, 2, 2, 3, 3, 3};
+  EXPECT_TRUE(ft::equal(s.begin(), s.end(), expected));
+
+  ft::pair<ft::multiset<int>::iterator, ft::multiset<int>::iterator> range =
+      s.equal_range(2);
+  EXPECT_TRUE(range.first == s.lower_bound(2));
+  EXPECT_TRUE(range.second == s.find(3));
+  s.erase(range.first, range.second);
+  EXPECT_EQ(s.erase(3), 3);
+  EXPECT_EQ(s.size(), 2);
+
+  ft::multiset<int> other(arr, arr + 6);
+  s.splice(other);
+  EXPECT_EQ(s.count(1), 4);
+  EXPECT_TRUE(other.empty());
+}
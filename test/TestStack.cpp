@@ -2,6 +2,7 @@
 #include "vector.hpp"
 #include <gtest/gtest.h>
 #include <list>
+#include <string>
 #include <vector>
 
 TEST(TestStack, TestConstructor) {
@@ -166,3 +167,47 @@ TEST(TestStack, TestComparisonOperators) {
   ASSERT_FALSE(s == s2);
   ASSERT_TRUE(s != s2);
 }
+
+TEST(TestStack, TestStackSwap) {
+  ft::stack<int> s1;
+  ft::stack<int> s2;
+  for (int i = 0; i < 10; i++)
+    s1.push(i);
+  s2.push(42);
+  ft::swap(s1, s2);
+  ASSERT_EQ(s1.size(), 1);
+  ASSERT_EQ(s1.top(), 42);
+  ASSERT_EQ(s2.size(), 10);
+  ASSERT_EQ(s2.top(), 9);
+  s1.swap(s2);
+  ASSERT_EQ(s1.top(), 9);
+  ASSERT_EQ(s2.top(), 42);
+}
+
+TEST(TestStack, TestSmallVectorContainer) {
+  typedef ft::stack<int, ft::small_vector<int, 4>> small_stack;
+  small_stack s1;
+  small_stack s2;
+  for (int i = 0; i < 3; i++)
+    s1.push(i);
+  for (int i = 0; i < 10; i++)
+    s2.push(i);
+  ASSERT_EQ(s1.top(), 2);
+  ASSERT_TRUE(s1 < s2);
+  ft::swap(s1, s2);
+  ASSERT_EQ(s1.size(), 10);
+  ASSERT_EQ(s2.size(), 3);
+  while (s1.size() > 3)
+    s1.pop();
+  ASSERT_TRUE(s1 == s2);
+}
+
+#if FT_HAS_MOVE
+TEST(TestStack, TestStackPushMoves) {
+  ft::stack<std::string> s;
+  std::string value(32, 'm');
+  s.push(std::move(value));
+  EXPECT_TRUE(value.empty());
+  EXPECT_EQ(s.top(), std::string(32, 'm'));
+}
+#endif
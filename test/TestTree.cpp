@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "functional"
 #include "nullptr.hpp"
@@ -24,6 +26,564 @@ public:
   }
 };
 
+// Returns the black height of the subtree rooted at node, or -1 if any
+// red-black or binary search tree property is violated within it. Keys
+// must be strictly ordered, unless equal keys are allowed.
+template <class Tree>
+int black_height(const Tree &tree, typename Tree::node_ptr node,
+                 bool equal_keys = false) {
+  typename Tree::node_ptr nil = tree.get_nil();
+  if (node == nil)
+    return 1;
+  if (node->left != nil &&
+      (node->left->get_parent() != node ||
+       (equal_keys ? node->data < node->left->data
+                   : !(node->left->data < node->data))))
+    return -1;
+  if (node->right != nil &&
+      (node->right->get_parent() != node ||
+       (equal_keys ? node->right->data < node->data
+                   : !(node->data < node->right->data))))
+    return -1;
+  if (node->get_color() == ft::RED && (node->left->get_color() == ft::RED ||
+                                       node->right->get_color() == ft::RED))
+    return -1;
+  int left = black_height(tree, node->left, equal_keys);
+  int right = black_height(tree, node->right, equal_keys);
+  if (left < 0 || left != right)
+    return -1;
+  return left + (node->get_color() == ft::BLACK ? 1 : 0);
+}
+
+// Checks the minimum and maximum nodes cached in the sentinel
+template <class Tree> bool has_valid_bounds(const Tree &tree) {
+  typename Tree::node_ptr nil = tree.get_nil();
+  typename Tree::node_ptr min = tree.get_root();
+  typename Tree::node_ptr max = tree.get_root();
+  while (min != nil && min->left != nil)
+    min = min->left;
+  while (max != nil && max->right != nil)
+    max = max->right;
+  return nil->left == min && nil->right == max;
+}
+
+template <class Tree>
+bool is_valid_rb_tree(const Tree &tree, bool equal_keys = false) {
+  typename Tree::node_ptr root = tree.get_root();
+  if (!has_valid_bounds(tree))
+    return false;
+  if (root == tree.get_nil())
+    return tree.size() == 0;
+  return root->get_color() == ft::BLACK &&
+         root->get_parent() == tree.get_nil() &&
+         black_height(tree, root, equal_keys) > 0 &&
+         static_cast<typename Tree::size_type>(
+             ft::distance(tree.begin(), tree.end())) == tree.size();
+}
+
+const int kNumKeys = 1000;
+
+template <class Policy> class TestTreePolicy : public ::testing::Test {
+public:
+  typedef ft::RedBlackTree<int, int, ft::_Identity<int>, ft::less<int>,
+                           std::allocator<int>, Policy>
+      tree_type;
+
+  tree_type tree;
+
+  // Inserts 0 .. kNumKeys - 1 in a scrambled order
+  void SetUp() {
+    for (int i = 0; i < kNumKeys; i++)
+      tree.insert_unique((i * 7919) % kNumKeys);
+  }
+};
+
+typedef ::testing::Types<
+    ft::rb_default_policy, ft::rb_compact_policy, ft::rb_order_statistic_policy,
+    ft::rb_compact_augmented_policy<ft::rb_size_augment>>
+    TreePolicies;
+TYPED_TEST_SUITE(TestTreePolicy, TreePolicies);
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterInsert) {
+  EXPECT_EQ(this->tree.size(), kNumKeys);
+  EXPECT_TRUE(is_valid_rb_tree(this->tree));
+  int expected = 0;
+  for (typename TestFixture::tree_type::iterator it = this->tree.begin();
+       it != this->tree.end(); ++it)
+    EXPECT_EQ(*it, expected++);
+}
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterErase) {
+  for (int i = 0; i < kNumKeys; i += 3) {
+    this->tree.erase((i * 31) % kNumKeys);
+    ASSERT_TRUE(is_valid_rb_tree(this->tree));
+  }
+  for (int i = 0; i < kNumKeys; i++)
+    this->tree.erase(i);
+  EXPECT_TRUE(this->tree.empty());
+  EXPECT_TRUE(is_valid_rb_tree(this->tree));
+}
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterRangeErase) {
+  typedef typename TestFixture::tree_type tree_type;
+  const int ranges[][2] = {{0, 1},         {0, 2},          {1, 2},
+                           {0, 500},       {1, 999},        {500, kNumKeys},
+                           {998, kNumKeys}, {123, 877},     {0, kNumKeys - 1},
+                           {1, kNumKeys}};
+  for (std::size_t r = 0; r < sizeof(ranges) / sizeof(*ranges); r++) {
+    tree_type tree(this->tree);
+    int lo = ranges[r][0];
+    int hi = ranges[r][1];
+    typename tree_type::iterator last = tree.find(hi);
+    tree.erase(tree.find(lo), last);
+    ASSERT_TRUE(is_valid_rb_tree(tree)) << lo << ", " << hi;
+    ASSERT_EQ(tree.size(), static_cast<std::size_t>(kNumKeys - (hi - lo)));
+    int expected = 0;
+    for (typename tree_type::iterator it = tree.begin(); it != tree.end();
+         ++it, ++expected) {
+      if (expected == lo)
+        expected = hi;
+      ASSERT_EQ(*it, expected);
+    }
+    if (hi < kNumKeys) {
+      ASSERT_EQ(*last, hi);
+    }
+    tree.insert_unique(lo);
+    ASSERT_TRUE(is_valid_rb_tree(tree));
+  }
+}
+
+TYPED_TEST(TestTreePolicy, TestBoundsAfterEraseAtEnds) {
+  typename TestFixture::tree_type &tree = this->tree;
+  for (int i = 0; i < kNumKeys / 2; i++) {
+    tree.erase(tree.begin());
+    ASSERT_TRUE(has_valid_bounds(tree));
+    ASSERT_EQ(*tree.begin(), i + 1);
+    tree.erase(--tree.end());
+    ASSERT_TRUE(has_valid_bounds(tree));
+    if (!tree.empty()) {
+      ASSERT_EQ(*tree.rbegin(), kNumKeys - i - 2);
+    }
+  }
+  EXPECT_TRUE(tree.empty());
+  EXPECT_TRUE(tree.begin() == tree.end());
+  tree.insert_unique(42);
+  EXPECT_EQ(*tree.begin(), 42);
+  EXPECT_EQ(*tree.rbegin(), 42);
+}
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterHintedInsert) {
+  typename TestFixture::tree_type tree;
+  for (int i = 0; i < kNumKeys; i += 2)
+    tree.insert_unique(tree.end(), i);
+  typename TestFixture::tree_type::iterator hint = tree.begin();
+  for (int i = 1; i < kNumKeys; i += 2)
+    tree.insert_unique(++hint, i);
+  for (int i = 0; i < kNumKeys; i += 5)
+    tree.insert_unique(tree.begin(), -i);
+  EXPECT_TRUE(is_valid_rb_tree(tree));
+  EXPECT_EQ(tree.size(), kNumKeys + kNumKeys / 5 - 1);
+  EXPECT_EQ(*tree.begin(), 5 - kNumKeys);
+  EXPECT_EQ(*--tree.end(), kNumKeys - 1);
+}
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterEmplace) {
+  typename TestFixture::tree_type tree;
+  for (int i = 0; i < kNumKeys; i++)
+    tree.emplace_unique(ft::make_emplace_args((i * 7919) % kNumKeys));
+  typename TestFixture::tree_type::iterator hint = tree.begin();
+  for (int i = 0; i < kNumKeys; i += 3)
+    hint = tree.emplace_unique(hint, ft::make_emplace_args(i));
+  for (int i = 1; i <= 10; i++)
+    tree.emplace_unique(tree.begin(), ft::make_emplace_args(-i));
+  EXPECT_FALSE(tree.emplace_unique(ft::make_emplace_args(7)).second);
+  EXPECT_TRUE(is_valid_rb_tree(tree));
+  EXPECT_EQ(tree.size(), kNumKeys + 10);
+  EXPECT_EQ(*tree.begin(), -10);
+}
+
+TYPED_TEST(TestTreePolicy, TestInvariantsAfterSortedBuild) {
+  std::vector<int> keys;
+  for (int n = 0; n <= 130; n++) {
+    typename TestFixture::tree_type tree;
+    tree.insert_unique(ft::sorted_unique, keys.begin(), keys.end());
+    ASSERT_TRUE(is_valid_rb_tree(tree)) << "n = " << n;
+    ASSERT_EQ(tree.size(), static_cast<std::size_t>(n));
+    int expected = 0;
+    for (typename TestFixture::tree_type::iterator it = tree.begin();
+         it != tree.end(); ++it)
+      ASSERT_EQ(*it, expected++);
+    if (n > 0) {
+      ASSERT_EQ(*--tree.end(), n - 1);
+    }
+    keys.push_back(n);
+  }
+}
+
+TYPED_TEST(TestTreePolicy, TestSwap) {
+  typename TestFixture::tree_type other;
+  other.insert_unique(-1);
+  typename TestFixture::tree_type::iterator it = this->tree.begin();
+  this->tree.swap(other);
+  EXPECT_TRUE(is_valid_rb_tree(this->tree));
+  EXPECT_TRUE(is_valid_rb_tree(other));
+  EXPECT_EQ(this->tree.size(), 1);
+  EXPECT_EQ(other.size(), kNumKeys);
+  EXPECT_TRUE(other.begin() == it);
+  EXPECT_EQ(*this->tree.begin(), -1);
+  other.erase(0);
+  this->tree.insert_unique(0);
+  EXPECT_TRUE(is_valid_rb_tree(this->tree));
+  EXPECT_TRUE(is_valid_rb_tree(other));
+}
+
+TYPED_TEST(TestTreePolicy, TestCopy) {
+  typename TestFixture::tree_type copy(this->tree);
+  EXPECT_TRUE(is_valid_rb_tree(copy));
+  EXPECT_EQ(copy.size(), kNumKeys);
+  int expected = 0;
+  for (typename TestFixture::tree_type::iterator it = copy.begin();
+       it != copy.end(); ++it)
+    ASSERT_EQ(*it, expected++);
+  copy.erase(0);
+  copy.insert_unique(kNumKeys);
+  EXPECT_TRUE(is_valid_rb_tree(copy));
+  EXPECT_EQ(*this->tree.begin(), 0);
+
+  typename TestFixture::tree_type empty;
+  copy = empty;
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(copy.begin() == copy.end());
+  copy = this->tree;
+  EXPECT_TRUE(is_valid_rb_tree(copy));
+  EXPECT_EQ(copy.size(), kNumKeys);
+}
+
+TEST(TestTreeCopy, TestCopyNonTrivialValues) {
+  typedef ft::RedBlackTree<std::string, std::string,
+                           ft::_Identity<std::string>, ft::less<std::string>,
+                           std::allocator<std::string>>
+      tree_type;
+  tree_type tree;
+  for (int i = 0; i < 1000; i++)
+    tree.insert_unique(std::string(40, 'a' + i % 26) + char('0' + i % 10));
+  tree_type copy(tree);
+  EXPECT_TRUE(is_valid_rb_tree(copy));
+  EXPECT_EQ(copy.size(), tree.size());
+  tree_type::iterator it = tree.begin();
+  for (tree_type::iterator copied = copy.begin(); copied != copy.end();
+       ++copied, ++it)
+    ASSERT_EQ(*copied, *it);
+  copy.clear();
+  EXPECT_TRUE(copy.empty());
+  copy = tree;
+  EXPECT_EQ(copy.size(), tree.size());
+}
+
+TYPED_TEST(TestTreePolicy, TestSplit) {
+  typedef typename TestFixture::tree_type tree_type;
+  const int keys[] = {-1, 0, 1, 250, 500, 999, kNumKeys};
+  for (std::size_t k = 0; k < sizeof(keys) / sizeof(*keys); k++) {
+    tree_type tree(this->tree);
+    tree_type right;
+    right.insert_unique(-5);
+    tree.split(keys[k], right);
+    int cut = keys[k] < 0 ? 0 : keys[k];
+    ASSERT_TRUE(is_valid_rb_tree(tree)) << keys[k];
+    ASSERT_TRUE(is_valid_rb_tree(right)) << keys[k];
+    ASSERT_EQ(tree.size(), static_cast<std::size_t>(cut));
+    ASSERT_EQ(right.size(), static_cast<std::size_t>(kNumKeys - cut));
+    if (cut > 0) {
+      ASSERT_EQ(*tree.rbegin(), cut - 1);
+    }
+    if (cut < kNumKeys) {
+      ASSERT_EQ(*right.begin(), cut);
+    }
+    tree.insert_unique(-2);
+    right.erase(cut);
+    ASSERT_TRUE(is_valid_rb_tree(tree));
+    ASSERT_TRUE(is_valid_rb_tree(right));
+  }
+}
+
+TYPED_TEST(TestTreePolicy, TestJoin) {
+  typedef typename TestFixture::tree_type tree_type;
+  const int sizes[] = {0, 1, 10, 500, 999, kNumKeys};
+  for (std::size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    // Adjacent key ranges, joined in both directions
+    tree_type low(this->tree);
+    tree_type high;
+    low.split(sizes[s], high);
+    low.join(high);
+    ASSERT_TRUE(is_valid_rb_tree(low)) << sizes[s];
+    ASSERT_TRUE(high.empty());
+    ASSERT_TRUE(is_valid_rb_tree(high));
+    ASSERT_EQ(low.size(), kNumKeys);
+    ASSERT_TRUE(ft::equal(low.begin(), low.end(), this->tree.begin()));
+    low.split(sizes[s], high);
+    high.join(low);
+    ASSERT_TRUE(is_valid_rb_tree(high)) << sizes[s];
+    ASSERT_TRUE(low.empty());
+    ASSERT_EQ(high.size(), kNumKeys);
+    ASSERT_TRUE(ft::equal(high.begin(), high.end(), this->tree.begin()));
+  }
+
+  // Overlapping keys are moved one by one, duplicates stay behind
+  tree_type odd;
+  for (int i = 1; i < 2 * kNumKeys; i += 2)
+    odd.insert_unique(i);
+  odd.join(this->tree);
+  EXPECT_TRUE(is_valid_rb_tree(odd));
+  EXPECT_TRUE(is_valid_rb_tree(this->tree));
+  EXPECT_EQ(odd.size(), kNumKeys + kNumKeys / 2);
+  EXPECT_EQ(this->tree.size(), kNumKeys / 2);
+  EXPECT_EQ(*this->tree.begin(), 1);
+  EXPECT_EQ(*this->tree.rbegin(), kNumKeys - 1);
+}
+
+TYPED_TEST(TestTreePolicy, TestInsertEqual) {
+  typedef typename TestFixture::tree_type tree_type;
+  tree_type tree;
+  // Ten copies of each key, in a scrambled order
+  for (int i = 0; i < kNumKeys; i++)
+    tree.insert_equal((i * 7919) % kNumKeys / 10);
+  EXPECT_TRUE(is_valid_rb_tree(tree, true));
+  EXPECT_EQ(tree.size(), kNumKeys);
+  for (int k = -1; k <= kNumKeys / 10; k++) {
+    std::size_t expected = k < 0 || k == kNumKeys / 10 ? 0 : 10;
+    ASSERT_EQ(tree.count_multi(k), expected) << k;
+    ft::pair<typename tree_type::iterator, typename tree_type::iterator>
+        range = tree.equal_range_multi(k);
+    ASSERT_TRUE(range.first == tree.lower_bound(k)) << k;
+    ASSERT_TRUE(range.second == tree.upper_bound(k)) << k;
+  }
+
+  // Hinted inserts, right and wrong
+  tree.insert_equal(tree.lower_bound(50), 50);
+  tree.insert_equal(tree.end(), kNumKeys);
+  tree.insert_equal(tree.begin(), 70);
+  tree.insert_equal(tree.upper_bound(20), 20);
+  EXPECT_TRUE(is_valid_rb_tree(tree, true));
+  EXPECT_EQ(tree.count_multi(50), 11);
+  EXPECT_EQ(tree.count_multi(70), 11);
+  EXPECT_EQ(tree.count_multi(20), 11);
+  EXPECT_EQ(*tree.rbegin(), kNumKeys);
+
+  EXPECT_EQ(tree.erase(50), 11);
+  EXPECT_EQ(tree.count_multi(50), 0);
+  tree.erase(tree.lower_bound(10), tree.upper_bound(40));
+  EXPECT_TRUE(is_valid_rb_tree(tree, true));
+  EXPECT_EQ(tree.size(), kNumKeys + 4 - 11 - 311);
+  EXPECT_EQ(*tree.lower_bound(10), 41);
+}
+
+TYPED_TEST(TestTreePolicy, TestJoinEqual) {
+  typedef typename TestFixture::tree_type tree_type;
+  // Equal keys at the boundary are still joined, in both directions
+  tree_type low, high;
+  for (int i = 0; i < 600; i++)
+    low.insert_equal(i / 3);
+  for (int i = 0; i < 600; i++)
+    high.insert_equal(199 + i / 3);
+  low.join_equal(high);
+  EXPECT_TRUE(is_valid_rb_tree(low, true));
+  EXPECT_TRUE(high.empty());
+  EXPECT_EQ(low.size(), 1200);
+  EXPECT_EQ(low.count_multi(199), 6);
+
+  for (int i = 0; i < 30; i++)
+    high.insert_equal(-i / 10);
+  low.join_equal(high);
+  EXPECT_TRUE(is_valid_rb_tree(low, true));
+  EXPECT_EQ(low.size(), 1230);
+  EXPECT_EQ(*low.begin(), -2);
+
+  // Overlapping keys are all moved
+  tree_type odd;
+  for (int i = 1; i < 2 * kNumKeys; i += 2)
+    odd.insert_equal(i % 500);
+  odd.join_equal(this->tree);
+  EXPECT_TRUE(is_valid_rb_tree(odd, true));
+  EXPECT_TRUE(this->tree.empty());
+  EXPECT_EQ(odd.size(), 2 * kNumKeys);
+  EXPECT_EQ(odd.count_multi(1), 5);
+}
+
+// Returns the number of nodes in the subtree rooted at node, or -1 if a
+// size kept in the subtree is wrong
+template <class Tree>
+long checked_size(const Tree &tree, typename Tree::node_ptr node) {
+  if (node == tree.get_nil())
+    return 0;
+  long left = checked_size(tree, node->left);
+  long right = checked_size(tree, node->right);
+  if (left < 0 || right < 0 ||
+      node->size != static_cast<std::size_t>(left + 1 + right))
+    return -1;
+  return left + 1 + right;
+}
+
+template <class Tree> bool has_valid_sizes(const Tree &tree) {
+  return checked_size(tree, tree.get_root()) ==
+         static_cast<long>(tree.size());
+}
+
+template <class Policy>
+class TestTreeOrderStatistic : public TestTreePolicy<Policy> {};
+
+typedef ::testing::Types<
+    ft::rb_order_statistic_policy,
+    ft::rb_compact_augmented_policy<ft::rb_size_augment>>
+    SizePolicies;
+TYPED_TEST_SUITE(TestTreeOrderStatistic, SizePolicies);
+
+TYPED_TEST(TestTreeOrderStatistic, TestSizesAfterUpdates) {
+  typedef typename TestFixture::tree_type tree_type;
+  tree_type &tree = this->tree;
+  EXPECT_TRUE(has_valid_sizes(tree));
+  for (int i = 0; i < kNumKeys; i += 3)
+    tree.erase((i * 31) % kNumKeys);
+  EXPECT_TRUE(has_valid_sizes(tree));
+  tree.erase(tree.find(100), tree.find(700));
+  EXPECT_TRUE(has_valid_sizes(tree));
+  tree_type right;
+  tree.split(800, right);
+  EXPECT_TRUE(has_valid_sizes(tree));
+  EXPECT_TRUE(has_valid_sizes(right));
+  right.join(tree);
+  EXPECT_TRUE(has_valid_sizes(right));
+  tree_type copy(right);
+  EXPECT_TRUE(has_valid_sizes(copy));
+
+  std::vector<int> keys;
+  for (int i = 0; i < 100; i++)
+    keys.push_back(i);
+  tree_type built;
+  built.insert_unique(ft::sorted_unique, keys.begin(), keys.end());
+  EXPECT_TRUE(has_valid_sizes(built));
+}
+
+TYPED_TEST(TestTreeOrderStatistic, TestRankNthDistance) {
+  typedef typename TestFixture::tree_type tree_type;
+  tree_type &tree = this->tree;
+  for (int i = 1; i < kNumKeys; i += 2)
+    tree.erase(i);
+  for (int k = -1; k <= kNumKeys; k++)
+    ASSERT_EQ(tree.rank(k), static_cast<std::size_t>(k < 0 ? 0 : (k + 1) / 2));
+  for (int i = 0; i < kNumKeys / 2; i++) {
+    typename tree_type::iterator it = tree.nth(i);
+    ASSERT_EQ(*it, 2 * i);
+    ASSERT_EQ(tree.distance(tree.begin(), it), i);
+    ASSERT_EQ(tree.distance(it, tree.end()), kNumKeys / 2 - i);
+  }
+  EXPECT_TRUE(tree.nth(kNumKeys / 2) == tree.end());
+  EXPECT_EQ(tree.distance(tree.end(), tree.begin()), -kNumKeys / 2);
+  const tree_type &view = tree;
+  EXPECT_EQ(*view.nth(3), 6);
+  EXPECT_EQ(view.distance(view.begin(), view.end()), kNumKeys / 2);
+}
+
+// A hash of the values in order, so that combining in the wrong order or
+// skipping a value shows up in the summary
+struct Fingerprint {
+  unsigned long hash;
+  unsigned long power; // kBase raised to the number of values
+};
+
+struct fingerprint_monoid {
+  typedef Fingerprint result_type;
+  static const unsigned long kBase = 1000003;
+
+  Fingerprint identity() const {
+    Fingerprint f = {0, 1};
+    return f;
+  }
+
+  Fingerprint lift(int value) const {
+    Fingerprint f = {static_cast<unsigned long>(value) + 1, kBase};
+    return f;
+  }
+
+  Fingerprint combine(const Fingerprint &a, const Fingerprint &b) const {
+    Fingerprint f = {a.hash * b.power + b.hash, a.power * b.power};
+    return f;
+  }
+};
+
+template <class Tree>
+bool has_valid_aggregates(const Tree &tree, int lo, int hi) {
+  fingerprint_monoid m;
+  Fingerprint expected = m.identity();
+  for (typename Tree::const_iterator it = tree.begin(); it != tree.end();
+       ++it)
+    if (lo <= *it && *it <= hi)
+      expected = m.combine(expected, m.lift(*it));
+  Fingerprint actual = tree.aggregate(lo, hi);
+  return actual.hash == expected.hash && actual.power == expected.power;
+}
+
+template <class Tree> bool has_valid_aggregates(const Tree &tree) {
+  for (int lo = -5; lo <= kNumKeys + 5; lo += 37)
+    for (int hi = lo - 10; hi <= kNumKeys + 5; hi += 53)
+      if (!has_valid_aggregates(tree, lo, hi))
+        return false;
+  return true;
+}
+
+template <class Policy>
+class TestTreeAggregate : public TestTreePolicy<Policy> {};
+
+typedef ::testing::Types<
+    ft::rb_aggregate_policy<fingerprint_monoid>,
+    ft::rb_compact_augmented_policy<ft::rb_monoid_augment<fingerprint_monoid>>>
+    AggregatePolicies;
+TYPED_TEST_SUITE(TestTreeAggregate, AggregatePolicies);
+
+TYPED_TEST(TestTreeAggregate, TestAggregatesAfterUpdates) {
+  typedef typename TestFixture::tree_type tree_type;
+  tree_type &tree = this->tree;
+  EXPECT_TRUE(has_valid_aggregates(tree));
+  EXPECT_TRUE(has_valid_aggregates(tree, 0, kNumKeys - 1));
+  EXPECT_TRUE(has_valid_aggregates(tree, 500, 500));
+  for (int i = 0; i < kNumKeys; i += 3)
+    tree.erase((i * 31) % kNumKeys);
+  EXPECT_TRUE(has_valid_aggregates(tree));
+  tree.erase(tree.find(100), tree.find(700));
+  EXPECT_TRUE(has_valid_aggregates(tree));
+  tree_type right;
+  tree.split(800, right);
+  EXPECT_TRUE(has_valid_aggregates(tree));
+  EXPECT_TRUE(has_valid_aggregates(right));
+  right.join(tree);
+  EXPECT_TRUE(has_valid_aggregates(right));
+  tree_type copy(right);
+  EXPECT_TRUE(has_valid_aggregates(copy));
+  copy.clear();
+  EXPECT_TRUE(has_valid_aggregates(copy));
+
+  std::vector<int> keys;
+  for (int i = 0; i < 100; i++)
+    keys.push_back(i * 3);
+  copy.insert_unique(ft::sorted_unique, keys.begin(), keys.end());
+  EXPECT_TRUE(has_valid_aggregates(copy));
+}
+
+TEST(TestNode, TestCompactNodeLayout) {
+  EXPECT_LT(sizeof(ft::CompactNode<unsigned long>),
+            sizeof(ft::Node<unsigned long>));
+
+  ft::CompactNode<unsigned long> parent, child;
+  child.init(&parent, ft::RED);
+  EXPECT_EQ(child.get_parent(), &parent);
+  EXPECT_EQ(child.get_color(), ft::RED);
+  child.set_color(ft::BLACK);
+  EXPECT_EQ(child.get_parent(), &parent);
+  EXPECT_EQ(child.get_color(), ft::BLACK);
+  child.set_parent(&child);
+  EXPECT_EQ(child.get_parent(), &child);
+  EXPECT_EQ(child.get_color(), ft::BLACK);
+}
+
 TEST(TestNode, TestNodeConstructor) {
   ft::Node<int> node_zero;
   EXPECT_EQ(node_zero.parent, ft::_nullptr);
@@ -60,60 +620,60 @@ TEST(TestTreeConstructor, TestTreeDefaultConstructor) {
 // }
 
 TEST_F(TestTree, TestTreeInsert) {
-  EXPECT_EQ(tree.get_root()->data->first, 13);
+  EXPECT_EQ(tree.get_root()->data.first, 13);
   EXPECT_EQ(tree.get_root()->color, ft::color::BLACK);
   EXPECT_EQ(tree.get_root()->parent, tree.get_nil());
-  EXPECT_EQ(tree.get_root()->left->data->first, 8);
+  EXPECT_EQ(tree.get_root()->left->data.first, 8);
   EXPECT_EQ(tree.get_root()->left->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->left->left->data->first, 1);
+  EXPECT_EQ(tree.get_root()->left->left->data.first, 1);
   EXPECT_EQ(tree.get_root()->left->left->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->left->left->right->data->first, 6);
+  EXPECT_EQ(tree.get_root()->left->left->right->data.first, 6);
   EXPECT_EQ(tree.get_root()->left->left->right->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->left->right->data->first, 11);
+  EXPECT_EQ(tree.get_root()->left->right->data.first, 11);
   EXPECT_EQ(tree.get_root()->left->right->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->right->data->first, 17);
+  EXPECT_EQ(tree.get_root()->right->data.first, 17);
   EXPECT_EQ(tree.get_root()->right->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->right->left->data->first, 15);
+  EXPECT_EQ(tree.get_root()->right->left->data.first, 15);
   EXPECT_EQ(tree.get_root()->right->left->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->right->right->data->first, 25);
+  EXPECT_EQ(tree.get_root()->right->right->data.first, 25);
   EXPECT_EQ(tree.get_root()->right->right->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->right->right->left->data->first, 22);
+  EXPECT_EQ(tree.get_root()->right->right->left->data.first, 22);
   EXPECT_EQ(tree.get_root()->right->right->left->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->right->right->right->data->first, 27);
+  EXPECT_EQ(tree.get_root()->right->right->right->data.first, 27);
   EXPECT_EQ(tree.get_root()->right->right->right->color, ft::color::RED);
   EXPECT_EQ(tree.get_root()->right->right->right->right, tree.get_nil());
   EXPECT_EQ(tree.get_root()->right->right->right->left, tree.get_nil());
 }
 
 TEST_F(TestTree, TestRemove) {
-  EXPECT_EQ(tree.get_root()->data->first, 13);
+  EXPECT_EQ(tree.get_root()->data.first, 13);
 
   tree.erase(13);
-  EXPECT_EQ(tree.get_root()->data->first, 15);
+  EXPECT_EQ(tree.get_root()->data.first, 15);
   EXPECT_EQ(tree.get_root()->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->right->data->first, 25);
+  EXPECT_EQ(tree.get_root()->right->data.first, 25);
   EXPECT_EQ(tree.get_root()->right->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->right->left->data->first, 17);
+  EXPECT_EQ(tree.get_root()->right->left->data.first, 17);
   EXPECT_EQ(tree.get_root()->right->left->color, ft::color::BLACK);
   EXPECT_EQ(tree.size(), 9);
 
   tree.erase(11);
-  EXPECT_EQ(tree.get_root()->data->first, 15);
-  EXPECT_EQ(tree.get_root()->left->data->first, 6);
-  EXPECT_EQ(tree.get_root()->left->left->data->first, 1);
+  EXPECT_EQ(tree.get_root()->data.first, 15);
+  EXPECT_EQ(tree.get_root()->left->data.first, 6);
+  EXPECT_EQ(tree.get_root()->left->left->data.first, 1);
   EXPECT_EQ(tree.get_root()->left->left->left, tree.get_nil());
   EXPECT_EQ(tree.get_root()->left->left->right, tree.get_nil());
-  EXPECT_EQ(tree.get_root()->left->right->data->first, 8);
+  EXPECT_EQ(tree.get_root()->left->right->data.first, 8);
   EXPECT_EQ(tree.get_root()->left->right->left, tree.get_nil());
   EXPECT_EQ(tree.get_root()->left->right->right, tree.get_nil());
   EXPECT_EQ(tree.size(), 8);
 
   tree.erase(17);
-  EXPECT_EQ(tree.get_root()->right->data->first, 25);
+  EXPECT_EQ(tree.get_root()->right->data.first, 25);
   EXPECT_EQ(tree.get_root()->right->color, ft::color::RED);
-  EXPECT_EQ(tree.get_root()->right->left->data->first, 22);
+  EXPECT_EQ(tree.get_root()->right->left->data.first, 22);
   EXPECT_EQ(tree.get_root()->right->left->color, ft::color::BLACK);
-  EXPECT_EQ(tree.get_root()->right->right->data->first, 27);
+  EXPECT_EQ(tree.get_root()->right->right->data.first, 27);
   EXPECT_EQ(tree.get_root()->right->right->color, ft::color::BLACK);
   EXPECT_EQ(tree.size(), 7);
 
@@ -1,3 +1,4 @@
+#include "functional.hpp"
 #include "type_traits.hpp"
 #include <gtest/gtest.h>
 
@@ -39,3 +40,48 @@ TEST(TestIsIntegral, TestIsIntegralFalse) {
   ASSERT_TRUE(ft::is_integral<std::string &&>::value == false);
   ASSERT_TRUE(ft::is_integral<std::wstring &&>::value == false);
 }
+
+struct TrivialStruct {
+  int a;
+  double b;
+  char *c;
+};
+
+struct NonTrivialStruct {
+  NonTrivialStruct() {}
+  NonTrivialStruct(const NonTrivialStruct &) {}
+};
+
+TEST(TestIsFloatingPoint, TestIsFloatingPoint) {
+  ASSERT_TRUE(ft::is_floating_point<float>::value == true);
+  ASSERT_TRUE(ft::is_floating_point<const double>::value == true);
+  ASSERT_TRUE(ft::is_floating_point<long double>::value == true);
+  ASSERT_TRUE(ft::is_floating_point<int>::value == false);
+  ASSERT_TRUE(ft::is_floating_point<float *>::value == false);
+}
+
+TEST(TestIsTriviallyCopyable, TestIsTriviallyCopyable) {
+  ASSERT_TRUE(ft::is_trivially_copyable<int>::value == true);
+  ASSERT_TRUE(ft::is_trivially_copyable<unsigned long long>::value == true);
+  ASSERT_TRUE(ft::is_trivially_copyable<double>::value == true);
+  ASSERT_TRUE(ft::is_trivially_copyable<std::string *>::value == true);
+  ASSERT_TRUE(ft::is_trivially_copyable<TrivialStruct>::value == true);
+  ASSERT_TRUE(ft::is_trivially_copyable<std::string>::value == false);
+  ASSERT_TRUE(ft::is_trivially_copyable<NonTrivialStruct>::value == false);
+}
+
+TEST(TestIsTriviallyDestructible, TestIsTriviallyDestructible) {
+  ASSERT_TRUE(ft::is_trivially_destructible<int>::value == true);
+  ASSERT_TRUE(ft::is_trivially_destructible<double>::value == true);
+  ASSERT_TRUE(ft::is_trivially_destructible<std::string *>::value == true);
+  ASSERT_TRUE(ft::is_trivially_destructible<TrivialStruct>::value == true);
+  ASSERT_TRUE(ft::is_trivially_destructible<NonTrivialStruct>::value == true);
+  ASSERT_TRUE(ft::is_trivially_destructible<std::string>::value == false);
+}
+
+TEST(TestIsEmpty, TestIsEmpty) {
+  ASSERT_TRUE(ft::is_empty<ft::less<int>>::value == true);
+  ASSERT_TRUE(ft::is_empty<ft::true_type>::value == true);
+  ASSERT_TRUE(ft::is_empty<TrivialStruct>::value == false);
+  ASSERT_TRUE(ft::is_empty<std::string>::value == false);
+}
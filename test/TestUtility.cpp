@@ -83,3 +83,13 @@ TEST(TestMakePair, TestMakePair) {
   EXPECT_EQ(p3.first, "hello");
   EXPECT_EQ(p3.second, "world");
 }
+
+TEST(TestPair, TestPairPiecewiseConstructor) {
+  ft::pair<int, std::string> p(ft::piecewise_construct, 1,
+                               ft::make_emplace_args(3, 'x'));
+  ASSERT_EQ(p.first, 1);
+  ASSERT_EQ(p.second, "xxx");
+  ft::pair<int, std::string> empty(ft::piecewise_construct, 2,
+                                   ft::make_emplace_args());
+  ASSERT_EQ(empty.second, "");
+}
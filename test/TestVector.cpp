@@ -1,12 +1,67 @@
 #include <algorithm>
 #include <gtest/gtest.h>
+#include <map>
 #include <memory>
+#include <stdint.h>
 #include <string>
 
 #include "vector.hpp"
 
 ft::vector<int>::size_type init_capacity = 0;
 
+// Stateful allocator that tracks every allocation made through it
+struct AllocationCounter {
+  static int allocations;
+  static std::size_t bytes;        // currently allocated
+  static int mismatched_deallocations;
+  static std::map<void *, std::size_t> live; // sizes by address
+
+  static void reset() {
+    allocations = 0;
+    bytes = 0;
+    mismatched_deallocations = 0;
+    live.clear();
+  }
+};
+int AllocationCounter::allocations = 0;
+std::size_t AllocationCounter::bytes = 0;
+int AllocationCounter::mismatched_deallocations = 0;
+std::map<void *, std::size_t> AllocationCounter::live;
+
+template <class T, bool Propagate>
+struct CountingAllocator : public std::allocator<T> {
+  typedef ft::integral_constant<bool, Propagate> propagate_on_container_swap;
+  template <class U> struct rebind {
+    typedef CountingAllocator<U, Propagate> other;
+  };
+
+  int id;
+
+  explicit CountingAllocator(int id = 0) : id(id) {}
+  template <class U>
+  CountingAllocator(const CountingAllocator<U, Propagate> &other)
+      : id(other.id) {}
+
+  T *allocate(std::size_t n, const void * = 0) {
+    T *p = std::allocator<T>::allocate(n);
+    AllocationCounter::allocations++;
+    AllocationCounter::bytes += n * sizeof(T);
+    AllocationCounter::live[p] = n * sizeof(T);
+    return p;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    std::map<void *, std::size_t>::iterator it =
+        AllocationCounter::live.find(p);
+    if (it == AllocationCounter::live.end() || it->second != n * sizeof(T))
+      AllocationCounter::mismatched_deallocations++;
+    else
+      AllocationCounter::live.erase(it);
+    AllocationCounter::bytes -= n * sizeof(T);
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
 TEST(TestVectorConstructors, TestVectorDefaultConstructor) {
   ft::vector<int> v1;
   ft::vector<std::string> v2;
@@ -560,6 +615,34 @@ TEST(TestVectorModifiers, TestVectorSwap) {
   }
 }
 
+TEST(TestVectorModifiers, TestVectorSwapAllocators) {
+  typedef CountingAllocator<int, true> propagating;
+  ft::vector<int, propagating> v1(3, 100, propagating(1));
+  ft::vector<int, propagating> v2(5, 200, propagating(2));
+  int *data1 = &v1[0];
+  AllocationCounter::allocations = 0;
+  v1.swap(v2);
+  ASSERT_EQ(AllocationCounter::allocations, 0);
+  ASSERT_EQ(&v2[0], data1);
+  ASSERT_EQ(v1.get_allocator().id, 2);
+  ASSERT_EQ(v2.get_allocator().id, 1);
+  ASSERT_EQ(v1.size(), 5);
+  ASSERT_EQ(v2.size(), 3);
+
+  typedef CountingAllocator<int, false> fixed;
+  ft::vector<int, fixed> v3(3, 100, fixed(3));
+  ft::vector<int, fixed> v4(5, 200, fixed(4));
+  AllocationCounter::allocations = 0;
+  v3.swap(v4);
+  ASSERT_EQ(AllocationCounter::allocations, 0);
+  ASSERT_EQ(v3.get_allocator().id, 3);
+  ASSERT_EQ(v4.get_allocator().id, 4);
+  ASSERT_EQ(v3[4], 200);
+  ASSERT_EQ(v4[2], 100);
+
+  ASSERT_FALSE(ft::propagate_on_container_swap<std::allocator<int>>::value);
+}
+
 TEST(TestVectorModifiers, TestVectorClear) {
   ft::vector<int> v1;
 
@@ -638,9 +721,11 @@ TEST(TestVectorNonMemberFunctions, TestVectorRelationalOperators) {
 }
 
 TEST(TestVectorNonMemberFunctions, TestVectorSwapOverload) {
-  ft::vector<int> v1(3, 100);
-  ft::vector<int> v2(5, 200);
+  ft::vector<int, CountingAllocator<int, true>> v1(3, 100);
+  ft::vector<int, CountingAllocator<int, true>> v2(5, 200);
+  AllocationCounter::allocations = 0;
   ft::swap(v1, v2);
+  ASSERT_EQ(AllocationCounter::allocations, 0);
   ASSERT_EQ(v1.size(), 5);
   for (int i = 0; i < 5; ++i) {
     ASSERT_EQ(v1[i], 200);
@@ -650,3 +735,543 @@ TEST(TestVectorNonMemberFunctions, TestVectorSwapOverload) {
     ASSERT_EQ(v2[i], 100);
   }
 }
+
+TEST(TestVectorModifiers, TestVectorInsertEraseNonTrivial) {
+  ft::vector<std::string> v;
+  v.reserve(16);
+  for (int i = 0; i < 8; i++)
+    v.push_back(std::string(32, 'a' + i));
+  v.insert(v.begin() + 2, std::string(32, 'x'));
+  v.insert(v.begin() + 1, 2, std::string(32, 'y'));
+  // Inserting a copy of an element that moves
+  v.insert(v.begin(), v[5]);
+  ASSERT_EQ(v.size(), 12);
+  const char *expected = "cayybxcdefgh";
+  for (int i = 0; i < 12; i++)
+    ASSERT_EQ(v[i], std::string(32, expected[i]));
+
+  v.erase(v.begin() + 3);
+  v.erase(v.begin(), v.begin() + 4);
+  ASSERT_EQ(v.size(), 7);
+  for (int i = 0; i < 7; i++)
+    ASSERT_EQ(v[i], std::string(32, "xcdefgh"[i]));
+}
+
+struct Sample {
+  int id;
+  double value;
+};
+
+TEST(TestVectorModifiers, TestVectorInsertEraseTrivial) {
+  ft::vector<Sample> v;
+  v.reserve(8);
+  for (int i = 0; i < 6; i++) {
+    Sample s = {i, i * 0.5};
+    v.push_back(s);
+  }
+  Sample s = {42, 4.2};
+  v.insert(v.begin() + 3, 2, s);
+  v.insert(v.begin(), v[4]);
+  ASSERT_EQ(v.size(), 9);
+  int expected[] = {42, 0, 1, 2, 42, 42, 3, 4, 5};
+  for (int i = 0; i < 9; i++)
+    ASSERT_EQ(v[i].id, expected[i]);
+  v.erase(v.begin() + 4, v.begin() + 6);
+  v.erase(v.begin());
+  ASSERT_EQ(v.size(), 6);
+  for (int i = 0; i < 6; i++) {
+    ASSERT_EQ(v[i].id, i);
+    ASSERT_EQ(v[i].value, i * 0.5);
+  }
+}
+
+// Element type that counts its copies
+struct Copyable {
+  static int copies;
+  int value;
+
+  Copyable(int value = 0) : value(value) {}
+  Copyable(const Copyable &other) : value(other.value) { copies++; }
+};
+int Copyable::copies = 0;
+
+TEST(TestVectorGrowth, TestVectorInsertGrowsOnce) {
+  typedef CountingAllocator<int, true> counting;
+  ft::vector<int, counting> v;
+  v.push_back(1);
+  v.push_back(2);
+  v.push_back(3);
+  int range[100];
+  for (int i = 0; i < 100; i++)
+    range[i] = i;
+
+  // Far more than the doubled capacity fits in a single allocation
+  AllocationCounter::allocations = 0;
+  v.insert(v.begin() + 1, range, range + 100);
+  ASSERT_EQ(AllocationCounter::allocations, 1);
+  ASSERT_EQ(v.size(), 103);
+  ASSERT_EQ(v.capacity(), 103);
+  ASSERT_EQ(v[0], 1);
+  for (int i = 0; i < 100; i++)
+    ASSERT_EQ(v[i + 1], i);
+  ASSERT_EQ(v[101], 2);
+  ASSERT_EQ(v[102], 3);
+
+  // A small insertion grows by the growth factor
+  v.insert(v.end(), 5, 7);
+  ASSERT_EQ(v.capacity(), 206);
+  ASSERT_EQ(v.size(), 108);
+
+  ft::vector<int, counting> empty;
+  empty.insert(empty.begin(), 10, 42);
+  ASSERT_EQ(empty.capacity(), 10);
+  ASSERT_EQ(empty[9], 42);
+}
+
+TEST(TestVectorGrowth, TestVectorInsertRelocatesOnce) {
+  ft::vector<Copyable> v;
+  for (int i = 0; i < 8; i++)
+    v.push_back(Copyable(i));
+  ASSERT_EQ(v.capacity(), 8);
+
+  // Every existing element is copied once, straight past the gap
+  Copyable::copies = 0;
+  v.insert(v.begin() + 4, 3, Copyable(-1));
+  ASSERT_EQ(Copyable::copies, 8 + 1 + 3);
+  int expected[] = {0, 1, 2, 3, -1, -1, -1, 4, 5, 6, 7};
+  for (int i = 0; i < 11; i++)
+    ASSERT_EQ(v[i].value, expected[i]);
+}
+
+TEST(TestVectorGrowth, TestVectorGrowthPolicy) {
+  ft::vector<int, std::allocator<int>, ft::vector_growth_policy<3, 2>> v;
+  size_t expected[] = {1, 2, 3, 4, 6, 9, 13, 19, 28};
+  size_t step = 0;
+  for (int i = 0; i < 28; i++) {
+    v.push_back(i);
+    if (v.size() > expected[step])
+      step++;
+    ASSERT_EQ(v.capacity(), expected[step]);
+  }
+
+  ft::vector<int> doubling;
+  for (int i = 0; i < 17; i++)
+    doubling.push_back(i);
+  ASSERT_EQ(doubling.capacity(), 32);
+}
+
+class TestVectorAllocation : public ::testing::Test {
+protected:
+  typedef ft::vector<uint64_t, CountingAllocator<uint64_t, true>> tracked;
+
+  virtual void SetUp() { AllocationCounter::reset(); }
+
+  virtual void TearDown() {
+    EXPECT_EQ(AllocationCounter::bytes, 0u);
+    EXPECT_EQ(AllocationCounter::mismatched_deallocations, 0);
+  }
+
+  // Bytes held by the only live vector, which must match its capacity
+  static std::size_t bytes_for(const tracked &v) {
+    return v.capacity() * sizeof(uint64_t);
+  }
+};
+
+TEST_F(TestVectorAllocation, TestConstructors) {
+  {
+    tracked v;
+    EXPECT_EQ(AllocationCounter::allocations, 0);
+    EXPECT_EQ(AllocationCounter::bytes, 0u);
+  }
+  {
+    tracked v(10, 7);
+    EXPECT_EQ(AllocationCounter::bytes, 10 * sizeof(uint64_t));
+  }
+  {
+    uint64_t range[] = {1, 2, 3, 4, 5};
+    tracked v(range, range + 5);
+    EXPECT_EQ(AllocationCounter::bytes, 5 * sizeof(uint64_t));
+  }
+  {
+    tracked v;
+    v.reserve(16);
+    v.push_back(1);
+    v.push_back(2);
+    std::size_t before = AllocationCounter::bytes;
+    tracked copy(v);
+    EXPECT_EQ(copy.capacity(), 2);
+    EXPECT_EQ(AllocationCounter::bytes - before, 2 * sizeof(uint64_t));
+  }
+}
+
+TEST_F(TestVectorAllocation, TestAssignment) {
+  tracked small(2, 1);
+  tracked large(20, 2);
+  std::size_t large_bytes = 20 * sizeof(uint64_t);
+
+  small = large;
+  EXPECT_EQ(small.capacity(), 20);
+  EXPECT_EQ(AllocationCounter::bytes, 2 * large_bytes);
+
+  // Shrinking reuses the existing storage
+  {
+    tracked three(3, 3);
+    int allocations = AllocationCounter::allocations;
+    large = three;
+    EXPECT_EQ(AllocationCounter::allocations, allocations);
+    EXPECT_EQ(large.capacity(), 20);
+  }
+  EXPECT_EQ(AllocationCounter::bytes, 2 * large_bytes);
+
+  large.assign(40, 4);
+  EXPECT_EQ(AllocationCounter::bytes, large_bytes + bytes_for(large));
+  EXPECT_EQ(large.capacity(), 40);
+  uint64_t range[] = {1, 2, 3};
+  large.assign(range, range + 3);
+  EXPECT_EQ(large.capacity(), 40);
+  EXPECT_EQ(large[2], 3u);
+}
+
+TEST_F(TestVectorAllocation, TestMutators) {
+  tracked v;
+  v.reserve(10);
+  EXPECT_EQ(AllocationCounter::bytes, 10 * sizeof(uint64_t));
+  v.reserve(5);
+  EXPECT_EQ(AllocationCounter::bytes, 10 * sizeof(uint64_t));
+
+  for (int i = 0; i < 100; i++) {
+    v.push_back(i);
+    ASSERT_EQ(AllocationCounter::bytes, bytes_for(v));
+  }
+  v.insert(v.begin(), 200, 1);
+  EXPECT_EQ(AllocationCounter::bytes, bytes_for(v));
+  v.insert(v.begin() + 5, 9);
+  v.erase(v.begin(), v.begin() + 50);
+  v.erase(v.begin());
+  v.pop_back();
+  EXPECT_EQ(AllocationCounter::bytes, bytes_for(v));
+  v.resize(1000);
+  EXPECT_EQ(AllocationCounter::bytes, bytes_for(v));
+  v.resize(10);
+  v.clear();
+  EXPECT_EQ(AllocationCounter::bytes, bytes_for(v));
+  EXPECT_EQ(AllocationCounter::live.size(), 1u);
+}
+
+TEST(TestVectorCapacity, TestVectorShrinkToFit) {
+  ft::vector<std::string> v;
+  for (int i = 0; i < 100; i++)
+    v.push_back(std::string(32, 'a' + i % 26));
+  ASSERT_EQ(v.capacity(), 128);
+  v.erase(v.begin() + 10, v.end());
+  ASSERT_EQ(v.capacity(), 128);
+  v.shrink_to_fit();
+  ASSERT_EQ(v.capacity(), 10);
+  for (int i = 0; i < 10; i++)
+    ASSERT_EQ(v[i], std::string(32, 'a' + i));
+  v.clear();
+  v.shrink_to_fit();
+  ASSERT_EQ(v.capacity(), 0);
+  v.push_back("again");
+  ASSERT_EQ(v[0], "again");
+}
+
+TEST(TestVectorCapacity, TestVectorHysteresisPolicy) {
+  typedef ft::vector<int, std::allocator<int>, ft::vector_hysteresis_policy<>>
+      trimming;
+  trimming v;
+  for (int i = 0; i < 1024; i++)
+    v.push_back(i);
+  ASSERT_EQ(v.capacity(), 1024);
+
+  // Halves once a quarter or less of the capacity is in use
+  while (v.size() > 256)
+    v.pop_back();
+  ASSERT_EQ(v.capacity(), 1024);
+  v.pop_back();
+  ASSERT_EQ(v.capacity(), 512);
+  for (int i = 0; i < 255; i++)
+    ASSERT_EQ(v[i], i);
+
+  // Oscillating around the threshold does not reallocate
+  for (int i = 0; i < 10; i++) {
+    v.push_back(0);
+    v.pop_back();
+  }
+  ASSERT_EQ(v.capacity(), 512);
+
+  v.erase(v.begin(), v.begin() + 200);
+  ASSERT_EQ(v.capacity(), 256);
+  ASSERT_EQ(v[0], 200);
+  v.resize(10);
+  ASSERT_EQ(v.capacity(), 128);
+  v.clear();
+  ASSERT_EQ(v.capacity(), 64);
+
+  typedef ft::vector<int, std::allocator<int>,
+                     ft::vector_hysteresis_policy<ft::vector_default_policy,
+                                                  1, 2>>
+      eager;
+  eager e(100, 1);
+  e.resize(49);
+  ASSERT_EQ(e.capacity(), 50);
+  e.resize(24);
+  ASSERT_EQ(e.capacity(), 25);
+}
+
+class TestSmallVector : public ::testing::Test {
+protected:
+  typedef ft::small_vector<uint64_t, 4, CountingAllocator<uint64_t, true>>
+      small;
+
+  virtual void SetUp() { AllocationCounter::reset(); }
+
+  virtual void TearDown() {
+    EXPECT_EQ(AllocationCounter::bytes, 0u);
+    EXPECT_EQ(AllocationCounter::mismatched_deallocations, 0);
+  }
+};
+
+TEST_F(TestSmallVector, TestInline) {
+  small v;
+  EXPECT_EQ(v.capacity(), 4);
+  for (int i = 0; i < 3; i++)
+    v.push_back(i);
+  v.insert(v.begin(), 9);
+  v.erase(v.begin());
+  v.push_back(3);
+  EXPECT_EQ(AllocationCounter::allocations, 0);
+  small copy(v);
+  small assigned;
+  assigned = v;
+  small filled(3, 7);
+  EXPECT_EQ(AllocationCounter::allocations, 0);
+  EXPECT_TRUE(copy == v);
+  EXPECT_TRUE(assigned == v);
+  EXPECT_EQ(filled[2], 7u);
+}
+
+TEST_F(TestSmallVector, TestSpill) {
+  small v;
+  for (int i = 0; i < 5; i++)
+    v.push_back(i);
+  EXPECT_EQ(AllocationCounter::allocations, 1);
+  EXPECT_EQ(v.capacity(), 8);
+  for (int i = 0; i < 5; i++)
+    ASSERT_EQ(v[i], uint64_t(i));
+
+  // Shrinking moves the elements back inline once they fit
+  v.pop_back();
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_EQ(AllocationCounter::bytes, 0u);
+  for (int i = 0; i < 4; i++)
+    ASSERT_EQ(v[i], uint64_t(i));
+  v.push_back(4);
+  v.push_back(5);
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 6);
+
+  small copy(v);
+  EXPECT_EQ(copy.capacity(), 6);
+  EXPECT_TRUE(copy == v);
+  small filled(10, 1);
+  EXPECT_EQ(filled.capacity(), 10);
+}
+
+TEST_F(TestSmallVector, TestSwap) {
+  small a(2, 1);
+  small b(3, 2);
+  small c(10, 3);
+  small d(20, 4);
+
+  ft::swap(a, b);
+  EXPECT_EQ(a.size(), 3);
+  EXPECT_EQ(b.size(), 2);
+  EXPECT_EQ(a[0], 2u);
+  EXPECT_EQ(b[0], 1u);
+
+  // Heap storage changes hands without allocating
+  int allocations = AllocationCounter::allocations;
+  c.swap(d);
+  EXPECT_EQ(AllocationCounter::allocations, allocations);
+  EXPECT_EQ(c.size(), 20);
+  EXPECT_EQ(d[0], 3u);
+
+  a.swap(c);
+  EXPECT_EQ(a.size(), 20);
+  EXPECT_EQ(a[19], 4u);
+  EXPECT_EQ(c.size(), 3);
+  EXPECT_EQ(c[2], 2u);
+}
+
+TEST(TestVectorModifiers, TestSmallVectorNonTrivial) {
+  ft::small_vector<std::string, 2> v;
+  v.push_back("a");
+  v.push_back("b");
+  v.insert(v.begin() + 1, 3, std::string(32, 'x'));
+  ASSERT_EQ(v.size(), 5);
+  ASSERT_EQ(v[0], "a");
+  ASSERT_EQ(v[3], std::string(32, 'x'));
+  ASSERT_EQ(v[4], "b");
+  v.erase(v.begin() + 1, v.end() - 1);
+  v.shrink_to_fit();
+  ASSERT_EQ(v.capacity(), 2);
+  ASSERT_EQ(v[1], "b");
+}
+
+// Element type that counts how it was constructed
+struct Constructed {
+  static int constructions; // from arguments
+  static int copies;
+  int a;
+  int b;
+
+  Constructed() : a(0), b(0) { constructions++; }
+  Constructed(int a, int b) : a(a), b(b) { constructions++; }
+  Constructed(const Constructed &other) : a(other.a), b(other.b) { copies++; }
+
+  static void reset() { constructions = copies = 0; }
+};
+int Constructed::constructions = 0;
+int Constructed::copies = 0;
+
+TEST(TestVectorModifiers, TestVectorEmplaceBack) {
+  ft::vector<Constructed> v;
+  v.reserve(2);
+  Constructed::reset();
+  v.emplace_back(1, 2);
+  v.emplace_back();
+  ASSERT_EQ(Constructed::constructions, 2);
+  ASSERT_EQ(Constructed::copies, 0);
+  ASSERT_EQ(v[0].b, 2);
+
+  // Reallocating copies the old elements, never the new one
+  v.emplace_back(3, 4);
+  ASSERT_EQ(Constructed::constructions, 3);
+  ASSERT_EQ(Constructed::copies, 2);
+  ASSERT_EQ(v.size(), 3);
+  ASSERT_EQ(v[0].a, 1);
+  ASSERT_EQ(v[1].a, 0);
+  ASSERT_EQ(v[2].b, 4);
+
+  // Arguments may refer into the vector, even when it reallocates
+  v.shrink_to_fit();
+  v.emplace_back(v[0]);
+  ASSERT_EQ(v[3].a, 1);
+  ASSERT_EQ(v[3].b, 2);
+}
+
+TEST(TestVectorModifiers, TestVectorEmplace) {
+  ft::vector<std::string> v;
+  v.emplace(v.end(), 3, 'c');
+  ft::vector<std::string>::iterator it = v.emplace(v.begin(), "a");
+  ASSERT_EQ(*it, "a");
+  it = v.emplace(v.begin() + 1, std::string("bbb"), 1, 1);
+  ASSERT_EQ(*it, "b");
+  v.reserve(10);
+  it = v.emplace(v.begin(), v[2]);
+  ASSERT_EQ(it, v.begin());
+  ASSERT_EQ(v.size(), 4);
+  ASSERT_EQ(v[0], "ccc");
+  ASSERT_EQ(v[1], "a");
+  ASSERT_EQ(v[2], "b");
+  ASSERT_EQ(v[3], "ccc");
+
+  ft::small_vector<int, 2> small;
+  small.emplace_back(1);
+  small.emplace(small.begin(), 0);
+  small.emplace_back(2);
+  ASSERT_EQ(small.size(), 3);
+  ASSERT_EQ(small[0], 0);
+  ASSERT_EQ(small[2], 2);
+}
+
+#if FT_HAS_MOVE
+// Element type that counts its copies and moves
+template <bool NothrowMove> struct Movable {
+  static int copies;
+  static int moves;
+  std::string value;
+
+  Movable(const std::string &value = "") : value(value) {}
+  Movable(const Movable &other) : value(other.value) { copies++; }
+  Movable(Movable &&other) noexcept(NothrowMove)
+      : value(std::move(other.value)) {
+    moves++;
+  }
+
+  static void reset() { copies = moves = 0; }
+};
+template <bool NothrowMove> int Movable<NothrowMove>::copies = 0;
+template <bool NothrowMove> int Movable<NothrowMove>::moves = 0;
+
+TEST(TestVectorMove, TestVectorRelocatesByMove) {
+  typedef Movable<true> movable;
+  ft::vector<movable> v;
+  movable::reset();
+  for (int i = 0; i < 100; i++)
+    v.push_back(movable(std::string(32, 'a' + i % 26)));
+  v.insert(v.begin(), movable("front"));
+  v.erase(v.begin() + 1);
+  EXPECT_EQ(movable::copies, 0);
+  EXPECT_GT(movable::moves, 100);
+  EXPECT_EQ(v[0].value, "front");
+  EXPECT_EQ(v[99].value, std::string(32, 'a' + 99 % 26));
+
+  // A move constructor that may throw is not used for relocation
+  typedef Movable<false> throwing;
+  ft::vector<throwing> w;
+  throwing::reset();
+  for (int i = 0; i < 100; i++)
+    w.push_back(throwing("x"));
+  EXPECT_EQ(throwing::moves, 100);
+  EXPECT_GT(throwing::copies, 100);
+}
+
+TEST(TestVectorMove, TestVectorMoveConstructorAndAssignment) {
+  ft::vector<std::string> v(10, std::string(32, 'x'));
+  const std::string *data = &v[0];
+  ft::vector<std::string> moved(std::move(v));
+  EXPECT_EQ(&moved[0], data);
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.capacity(), 0);
+
+  ft::vector<std::string> assigned(3, "y");
+  assigned = std::move(moved);
+  EXPECT_EQ(&assigned[0], data);
+  EXPECT_EQ(assigned.size(), 10);
+  EXPECT_TRUE(moved.empty());
+  v.push_back("reused");
+  EXPECT_EQ(v[0], "reused");
+}
+
+TEST(TestVectorMove, TestSmallVectorMove) {
+  typedef ft::small_vector<std::string, 4> small;
+  small inline_source(2, std::string(32, 'i'));
+  small inline_moved(std::move(inline_source));
+  EXPECT_EQ(inline_moved.size(), 2);
+  EXPECT_EQ(inline_moved[1], std::string(32, 'i'));
+  EXPECT_EQ(inline_moved.capacity(), 4);
+
+  small heap_source(10, "h");
+  const std::string *data = &heap_source[0];
+  small heap_moved(std::move(heap_source));
+  EXPECT_EQ(&heap_moved[0], data);
+  EXPECT_TRUE(heap_source.empty());
+  EXPECT_EQ(heap_source.capacity(), 4);
+  heap_source.push_back("again");
+  EXPECT_EQ(heap_source[0], "again");
+
+  inline_moved = std::move(heap_moved);
+  EXPECT_EQ(inline_moved.size(), 10);
+  small other(20, "o");
+  data = &other[0];
+  inline_moved = std::move(other);
+  EXPECT_EQ(&inline_moved[0], data);
+  EXPECT_TRUE(other.empty());
+  ft::swap(inline_moved, heap_source);
+  EXPECT_EQ(inline_moved[0], "again");
+  EXPECT_EQ(heap_source.size(), 20);
+}
+#endif